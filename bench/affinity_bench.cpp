@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "pb_sdk/cpu_affinity.h"
+#include "yolov8s_pose/preprocess.h"
+
+namespace {
+
+struct LatencyStats {
+    double p50;
+    double p99;
+    double max;
+};
+
+LatencyStats summarize(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double q) { return samples[static_cast<size_t>(q * (samples.size() - 1))]; };
+    return {at(0.50), at(0.99), samples.back()};
+}
+
+/**
+ * @brief 在独立线程中逐帧预处理，返回每帧耗时（毫秒）
+ */
+std::vector<double> run_frames(const cv::Mat& bgr, const LetterboxPlan& plan, int frames,
+                               const AffinityConfig* affinity) {
+    std::vector<double> samples;
+    samples.reserve(frames);
+    std::thread worker([&] {
+        yolov8sPreprocess preprocessor;
+        const std::vector<int64_t> shape{1, 3, plan.out_size.height, plan.out_size.width};
+        torch::Tensor out;
+        if (affinity != nullptr) {
+            pin_current_thread(affinity->preprocess_cpus);
+            // 在绑核后从页对齐的节点缓冲区池取输出，首次写入时在 buffer_node 上分配物理页
+            const size_t bytes = static_cast<size_t>(3) * shape[2] * shape[3] * sizeof(at::Half);
+            NodeBufferPool buffers(bytes, affinity->buffer_node);
+            std::shared_ptr<void> buffer = buffers.acquire();
+            if (buffer) {
+                out = torch::from_blob(buffer.get(), shape, [buffer](void*) {}, torch::dtype(torch::kHalf));
+            }
+        }
+        if (!out.defined()) {
+            out = torch::empty(shape, torch::dtype(torch::kHalf));
+        }
+        for (int i = 0; i < frames; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            out = preprocessor.preprocess(bgr, plan, out);
+            auto end = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+    });
+    worker.join();
+    return samples;
+}
+
+}  // namespace
+
+/**
+ * 在后台解码负载（模拟相机解码线程）下，对比预处理线程绑核前后的延迟抖动。
+ * 用法: yolov8_affinity_bench [config] [frames]
+ */
+int main(int argc, char* argv[]) {
+    std::string config_path = argc > 1 ? argv[1] : "pb_infer/pb_infer.json";
+    int frames = argc > 2 ? std::stoi(argv[2]) : 500;
+    const int imgsz = 640;
+
+    AffinityConfig affinity = load_affinity_config(config_path);
+    if (affinity.preprocess_cpus.empty()) {
+        std::cerr << "No preprocess cpus in " << config_path << ", pinned run is identical to unpinned" << std::endl;
+    }
+    verify_cpu_isolation("preprocess", affinity.preprocess_cpus);
+
+    cv::Mat bgr(1080, 1920, CV_8UC3);
+    cv::randu(bgr, cv::Scalar::all(0), cv::Scalar::all(255));
+    std::vector<uint8_t> jpeg;
+    cv::imencode(".jpg", bgr, jpeg);
+    auto plan = LetterboxPlanCache::instance().get(bgr.size(), imgsz);
+
+    // 后台解码负载，线程数与核数相同，不绑核
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> load;
+    for (unsigned i = 0; i < std::max(1u, std::thread::hardware_concurrency()); ++i) {
+        load.emplace_back([&] {
+            pin_current_thread(affinity.decode_cpus);
+            while (!stop.load(std::memory_order_relaxed)) {
+                cv::imdecode(jpeg, cv::IMREAD_COLOR);
+            }
+        });
+    }
+
+    LatencyStats unpinned = summarize(run_frames(bgr, *plan, frames, nullptr));
+    LatencyStats pinned = summarize(run_frames(bgr, *plan, frames, &affinity));
+
+    stop = true;
+    for (auto& thread : load) {
+        thread.join();
+    }
+
+    std::cout << "frames " << frames << ", decode load threads " << load.size() << std::endl;
+    std::cout << "unpinned: p50 " << unpinned.p50 << " ms, p99 " << unpinned.p99 << " ms, max " << unpinned.max
+              << " ms, jitter(p99-p50) " << unpinned.p99 - unpinned.p50 << " ms" << std::endl;
+    std::cout << "pinned:   p50 " << pinned.p50 << " ms, p99 " << pinned.p99 << " ms, max " << pinned.max
+              << " ms, jitter(p99-p50) " << pinned.p99 - pinned.p50 << " ms" << std::endl;
+    return 0;
+}
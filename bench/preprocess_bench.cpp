@@ -0,0 +1,97 @@
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "yolov8s_pose/preprocess.h"
+
+namespace {
+
+double time_ms(const std::function<void()>& func, int iters) {
+    func();  // 预热
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iters; ++i) {
+        func();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / iters;
+}
+
+}  // namespace
+
+/**
+ * 对比各输入路径的单帧预处理耗时：
+ *   jpeg: imdecode(BGR) -> preprocess(Mat)
+ *   bgr: preprocess(Mat)
+ *   bgr plan: preprocess(Mat, LetterboxPlan)，复用输出张量
+ *   bgr plan u8: preprocess_u8(Mat, LetterboxPlan)，uint8 NHWC 输入
+ *   nv12->bgr: cvtColor(NV12->BGR) -> preprocess(Mat)
+ *   nv12 fused: preprocess(YuvFrame)
+ */
+int main(int argc, char* argv[]) {
+    int width = argc > 1 ? std::stoi(argv[1]) : 1920;
+    int height = argc > 2 ? std::stoi(argv[2]) : 1080;
+    int iters = argc > 3 ? std::stoi(argv[3]) : 50;
+    const int imgsz = 640;
+
+    cv::Mat bgr(height, width, CV_8UC3);
+    cv::randu(bgr, cv::Scalar::all(0), cv::Scalar::all(255));
+    cv::GaussianBlur(bgr, bgr, cv::Size(7, 7), 0);
+
+    std::vector<uint8_t> jpeg;
+    cv::imencode(".jpg", bgr, jpeg);
+
+    // 构造 NV12：I420 的 U/V 平面交织为 UV 平面
+    cv::Mat i420;
+    cv::cvtColor(bgr, i420, cv::COLOR_BGR2YUV_I420);
+    const size_t y_size = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> nv12(y_size * 3 / 2);
+    std::memcpy(nv12.data(), i420.data, y_size);
+    const uint8_t* u = i420.data + y_size;
+    const uint8_t* v = u + y_size / 4;
+    for (size_t i = 0; i < y_size / 4; ++i) {
+        nv12[y_size + i * 2] = u[i];
+        nv12[y_size + i * 2 + 1] = v[i];
+    }
+
+    yolov8sPreprocess preprocessor;
+    double jpeg_ms = time_ms([&] {
+        cv::Mat img = cv::imdecode(jpeg, cv::IMREAD_COLOR);
+        preprocessor.preprocess(img, imgsz);
+    }, iters);
+    auto plan = LetterboxPlanCache::instance().get(bgr.size(), imgsz);
+    torch::Tensor reuse;
+    double mat_ms = time_ms([&] {
+        preprocessor.preprocess(bgr, imgsz);
+    }, iters);
+    double plan_ms = time_ms([&] {
+        reuse = preprocessor.preprocess(bgr, *plan, reuse);
+    }, iters);
+    torch::Tensor reuse_u8;
+    double plan_u8_ms = time_ms([&] {
+        reuse_u8 = preprocessor.preprocess_u8(bgr, *plan, reuse_u8);
+    }, iters);
+    double convert_ms = time_ms([&] {
+        cv::Mat yuv(height * 3 / 2, width, CV_8UC1, nv12.data());
+        cv::Mat img;
+        cv::cvtColor(yuv, img, cv::COLOR_YUV2BGR_NV12);
+        preprocessor.preprocess(img, imgsz);
+    }, iters);
+    double fused_ms = time_ms([&] {
+        preprocessor.preprocess_nv12(nv12.data(), nv12.data() + y_size, width, height, imgsz);
+    }, iters);
+
+    std::cout << "frame " << width << "x" << height << " -> " << imgsz << ", iters " << iters << std::endl;
+    std::cout << "jpeg imdecode + preprocess(Mat): " << jpeg_ms << " ms" << std::endl;
+    std::cout << "bgr preprocess(Mat):             " << mat_ms << " ms" << std::endl;
+    std::cout << "bgr preprocess(Mat, plan):       " << plan_ms << " ms" << std::endl;
+    std::cout << "bgr preprocess_u8(Mat, plan):    " << plan_u8_ms << " ms" << std::endl;
+    std::cout << "bytes per frame: float16 " << reuse.nbytes() << ", uint8 " << reuse_u8.nbytes() << std::endl;
+    std::cout << "nv12 cvtColor + preprocess(Mat): " << convert_ms << " ms" << std::endl;
+    std::cout << "nv12 fused preprocess:           " << fused_ms << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "pb_sdk/sampler.h"
+
+namespace {
+
+/**
+ * @brief 对照实现：全词表惩罚、全词表 partial_sort 后按 top-k / top-p / min-p 截断并按概率加权抽样
+ *
+ * @details 缓冲区在调用间复用，计时只包含计算本身。allowed() 返回上一次调用允许的 token 集合
+ *          （排序后的前 keep 个），用于检查 TokenSampler 的结果是否落在其中。
+ */
+class NaiveSampler
+{
+public:
+    NaiveSampler(int vocab, const SamplerConfig& config) : m_config(config), m_probs(vocab), m_order(vocab) {}
+
+    int sample(std::vector<float>& logits, const std::vector<int>& generated, const std::vector<char>& in_prompt,
+               std::mt19937_64& rng) {
+        const int vocab = static_cast<int>(logits.size());
+        for (int i = 0; i < vocab; ++i) {
+            if (generated[i] > 0 || in_prompt[i]) {
+                float logit = logits[i];
+                logit = logit > 0.0f ? logit / m_config.repetition_penalty : logit * m_config.repetition_penalty;
+                if (generated[i] > 0) {
+                    logit -= m_config.frequency_penalty * generated[i] + m_config.presence_penalty;
+                }
+                logits[i] = logit;
+            }
+        }
+        int k = m_config.top_k;
+        if (m_config.meta_top_k > 0 && (k <= 0 || k > m_config.meta_top_k)) {
+            k = m_config.meta_top_k;
+        }
+        const bool limited = k > 0 && k < vocab;
+        const int n = limited ? k : vocab;
+        for (int i = 0; i < vocab; ++i) {
+            m_order[i] = i;
+        }
+        std::partial_sort(m_order.begin(), m_order.begin() + n, m_order.end(), [&](int a, int b) {
+            return logits[a] > logits[b] || (logits[a] == logits[b] && a < b);
+        });
+
+        const float max_logit = logits[m_order[0]];
+        const float inv_temp = 1.0f / m_config.temperature;
+        float total = 0.0f;
+        for (int i = 0; i < n; ++i) {
+            m_probs[i] = std::exp((logits[m_order[i]] - max_logit) * inv_temp);
+        }
+        if (limited) {
+            for (int i = 0; i < n; ++i) {
+                total += m_probs[i];
+            }
+        } else {
+            // 与 TokenSampler 相同，全词表的概率和按 token 顺序累加
+            for (int i = 0; i < vocab; ++i) {
+                total += std::exp((logits[i] - max_logit) * inv_temp);
+            }
+        }
+
+        m_keep = n;
+        if (m_config.top_p < 1.0f) {
+            float cumulative = 0.0f;
+            for (int i = 0; i < n; ++i) {
+                cumulative += m_probs[i];
+                if (cumulative >= m_config.top_p * total) {
+                    m_keep = i + 1;
+                    break;
+                }
+            }
+        }
+        if (m_config.min_p > 0.0f) {
+            int above = 1;
+            while (above < m_keep && m_probs[above] >= m_config.min_p * m_probs[0]) {
+                above++;
+            }
+            m_keep = above;
+        }
+
+        float kept_sum = 0.0f;
+        for (int i = 0; i < m_keep; ++i) {
+            kept_sum += m_probs[i];
+        }
+        double target = std::uniform_real_distribution<double>(0.0, kept_sum)(rng);
+        for (int i = 0; i < m_keep; ++i) {
+            target -= m_probs[i];
+            if (target < 0.0) {
+                return m_order[i];
+            }
+        }
+        return m_order[m_keep - 1];
+    }
+
+    bool allowed(int token) const {
+        return std::find(m_order.begin(), m_order.begin() + m_keep, token) != m_order.begin() + m_keep;
+    }
+
+private:
+    SamplerConfig       m_config;
+    std::vector<float>  m_probs;
+    std::vector<int>    m_order;
+    int                 m_keep = 0;
+};
+
+}  // namespace
+
+/**
+ * 单 token 采样耗时对比（微秒/token），并检查结果落在对照实现的 top-k/top-p/min-p 集合内。
+ * 用法: sampler_bench [vocab_size] [top_k] [seen_tokens] [iters]
+ */
+int main(int argc, char* argv[]) {
+    int vocab = argc > 1 ? std::stoi(argv[1]) : 151936;
+    int top_k = argc > 2 ? std::stoi(argv[2]) : 50;
+    int seen = argc > 3 ? std::stoi(argv[3]) : 2048;
+    int iters = argc > 4 ? std::stoi(argv[4]) : 200;
+
+    SamplerConfig config;
+    config.temperature = 0.7f;
+    config.top_k = top_k;
+    config.meta_top_k = 0;
+    config.top_p = 0.9f;
+    config.min_p = 0.05f;
+    config.repetition_penalty = 1.1f;
+    config.presence_penalty = 0.2f;
+    config.frequency_penalty = 0.1f;
+    config.seed = 1234;
+
+    std::mt19937_64 rng(42);
+    std::normal_distribution<float> dist(0.0f, 3.0f);
+    std::vector<float> base(vocab);
+    for (auto& logit : base) {
+        logit = dist(rng);
+    }
+
+    // 前一半作为 prompt，后一半作为已生成 token
+    TokenSampler sampler(vocab, config);
+    std::vector<int> generated(vocab, 0);
+    std::vector<char> in_prompt(vocab, 0);
+    std::uniform_int_distribution<int> token_dist(0, vocab - 1);
+    for (int i = 0; i < seen; ++i) {
+        int token = token_dist(rng);
+        if (i < seen / 2) {
+            sampler.accept_prompt(token);
+            in_prompt[token] = 1;
+        } else {
+            sampler.accept(token);
+            generated[token]++;
+        }
+    }
+
+    NaiveSampler naive(vocab, config);
+    std::vector<float> logits(vocab);
+    using clock = std::chrono::steady_clock;
+    double naive_us = 0.0;
+    double sampler_us = 0.0;
+    int outside = 0;
+    for (int i = 0; i < iters; ++i) {
+        logits = base;
+        auto start = clock::now();
+        naive.sample(logits, generated, in_prompt, rng);
+        naive_us += std::chrono::duration<double, std::micro>(clock::now() - start).count();
+
+        logits = base;
+        start = clock::now();
+        int token = sampler.sample(logits.data());
+        sampler_us += std::chrono::duration<double, std::micro>(clock::now() - start).count();
+        outside += naive.allowed(token) ? 0 : 1;
+    }
+
+    // 相同 seed 的两个采样器与新实例重放应给出相同序列；不同 seed 的序列只做输出（top_k=1 时本应相同）
+    SamplerConfig other_seed = config;
+    other_seed.seed = 4321;
+    TokenSampler a(vocab, config);
+    TokenSampler b(vocab, config);
+    TokenSampler c(vocab, other_seed);
+    std::vector<int> first;
+    bool deterministic = true;
+    bool seed_matters = false;
+    for (int i = 0; i < 64; ++i) {
+        std::vector<float> la = base;
+        std::vector<float> lb = base;
+        std::vector<float> lc = base;
+        int token = a.sample_and_accept(la.data());
+        first.push_back(token);
+        deterministic = deterministic && token == b.sample_and_accept(lb.data());
+        seed_matters = seed_matters || token != c.sample_and_accept(lc.data());
+    }
+    TokenSampler replay(vocab, config);
+    for (int i = 0; i < 64; ++i) {
+        std::vector<float> l = base;
+        deterministic = deterministic && replay.sample_and_accept(l.data()) == first[i];
+    }
+
+    std::cout << "vocab " << vocab << ", top_k " << top_k << ", seen tokens " << seen << std::endl;
+    std::cout << "naive (full-vocab penalty + partial_sort + weighted pick): " << naive_us / iters << " us/token" << std::endl;
+    std::cout << "TokenSampler (sparse penalty + radix select):            " << sampler_us / iters << " us/token" << std::endl;
+    std::cout << "samples outside the reference top-k/top-p/min-p set: " << outside << "/" << iters << std::endl;
+    std::cout << "seeded determinism: " << (deterministic ? "ok" : "FAILED")
+              << ", other seed differs: " << (seed_matters ? "yes" : "no") << std::endl;
+    return outside == 0 && deterministic ? 0 : -1;
+}
@@ -0,0 +1,49 @@
+#include <iostream>
+#include <string>
+
+#include "pb_sdk/video_ingest.h"
+
+/**
+ * 统计单个视频的采样、去重结果，并对比单线程与线程池的 seek 解码耗时。
+ * 用法: video_ingest_bench <video> [fps] [ve_ms_per_frame]
+ *   ve_ms_per_frame: 实测每帧视觉编码耗时（Metric::ve_time / 帧数），用于估算去重节省的时间
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <video> [fps] [ve_ms_per_frame]" << std::endl;
+        return -1;
+    }
+    std::string path = argv[1];
+    float fps = argc > 2 ? std::stof(argv[2]) : 1.0f;
+    double ve_ms_per_frame = argc > 3 ? std::stod(argv[3]) : 0.0;
+
+    VideoIngestConfig config;
+    config.fps = fps;
+    config.thread_nums = 1;
+    VideoIngestResult serial = VideoIngest(config).ingest(path);
+
+    config.thread_nums = 0;
+    VideoIngestResult result = VideoIngest(config).ingest(path);
+    if (result.frames.empty()) {
+        std::cerr << "No frames sampled from " << path << std::endl;
+        return -1;
+    }
+
+    const VideoIngestStats& stats = result.stats;
+    std::cout << "sampled " << stats.sampled << ", decoded " << stats.decoded << ", kept " << stats.kept
+              << ", dropped " << stats.dropped << std::endl;
+    std::cout << "decode: 1 thread " << serial.stats.decode_ms << " ms, pool " << stats.decode_ms
+              << " ms; dedup " << stats.dedup_ms << " ms" << std::endl;
+    const VlPixelData& pixel = result.pixel;
+    std::cout << "frame " << pixel.resized.width << "x" << pixel.resized.height << ", grid_thw " << pixel.grid_t
+              << "x" << pixel.grid_h << "x" << pixel.grid_w << ", pixel_data "
+              << pixel.pixel_data.size() * sizeof(uint16_t) << " bytes" << std::endl;
+    if (ve_ms_per_frame > 0.0) {
+        // 以保留帧的视觉编码耗时构造 Metric，与服务端返回的 ve_time 走同一估算
+        Metric metric{};
+        metric.ve_time = ve_ms_per_frame * stats.kept;
+        std::cout << "ve time saved (est) " << VideoIngest::estimate_ve_saved(metric, stats) << " ms per clip"
+                  << std::endl;
+    }
+    return 0;
+}
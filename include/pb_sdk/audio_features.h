@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "pb_infer_api.h"
+
+struct SRC_STATE_tag;
+
+/**
+ * @brief 对数梅尔特征参数（与 Whisper 特征提取一致，Omni 音频编码器使用）
+ */
+struct AudioFeatureConfig {
+    int sample_rate = 16000;
+    int n_fft = 400;
+    int hop_length = 160;
+    int n_mels = 128;
+};
+
+/**
+ * @brief 流式音频特征提取
+ *
+ * @details 音频按块到达时即完成解码、增量重采样与分帧 STFT/梅尔计算，
+ *          采集结束后只需处理尾部几帧，特征提取与采集重叠。
+ *          输出为 [n_mels, n_frames] 的 float16 打包张量。
+ *          重采样依赖 libsamplerate（PB_HAVE_SAMPLERATE），文件与内存解码依赖 libsndfile（PB_HAVE_SNDFILE）；
+ *          缺少对应库时相关接口返回失败，采样率与配置一致的 push_pcm 不受影响。
+ */
+class StreamingAudioFeatures
+{
+public:
+    explicit StreamingAudioFeatures(const AudioFeatureConfig& config = AudioFeatureConfig());
+    ~StreamingAudioFeatures();
+
+    StreamingAudioFeatures(const StreamingAudioFeatures&) = delete;
+    StreamingAudioFeatures& operator=(const StreamingAudioFeatures&) = delete;
+
+    /**
+     * @brief 输入一块交织 PCM 数据（如麦克风采集）
+     *
+     * @param [in]samples 交织的 float 采样，范围 [-1, 1]
+     * @param [in]frames 采样帧数
+     * @param [in]channels 声道数，多声道取平均
+     * @param [in]sample_rate 输入采样率，与配置不同时增量重采样
+     *
+     * @return 本次新增的特征帧数，失败返回 -1
+     */
+    int push_pcm(const float* samples, size_t frames, int channels, int sample_rate);
+
+    /**
+     * @brief 按块解码音频文件并提取特征（libsndfile 支持的格式）
+     *
+     * @param [in]path 音频文件路径
+     * @param [in]chunk_frames 每块解码的采样帧数
+     *
+     * @return 成功返回 true
+     */
+    bool push_file(const std::string& path, size_t chunk_frames = 4096);
+
+    /**
+     * @brief 按块解码内存中的编码音频（如 ContentPart::input_audio 的原始数据）
+     *
+     * @param [in]data 编码数据
+     * @param [in]len 编码数据长度
+     * @param [in]chunk_frames 每块解码的采样帧数
+     *
+     * @return 成功返回 true
+     */
+    bool push_encoded(const uint8_t* data, size_t len, size_t chunk_frames = 4096);
+
+    /**
+     * @brief 输入结束：冲刷重采样器并计算尾部帧
+     *
+     * @return 本次新增的特征帧数
+     */
+    int finish();
+
+    /**
+     * @brief 已计算的特征帧数
+     */
+    size_t num_frames() const { return m_log_mel.size() / m_config.n_mels; }
+
+    /**
+     * @brief 按 Whisper 规则归一化并打包为 float16，布局 [n_mels, n_frames]
+     */
+    std::vector<uint16_t> packed_fp16() const;
+
+    /**
+     * @brief 生成音频 ContentPart，特征放入 pixel_data
+     */
+    ContentPart to_content_part() const;
+
+    /**
+     * @brief 清空状态，开始新的音频
+     */
+    void reset();
+
+private:
+    void append_mono(const float* samples, size_t frames);
+    int compute_ready_frames(bool final);
+    void compute_frame(int64_t center);
+    float sample_at(int64_t index) const;
+
+private:
+    AudioFeatureConfig   m_config;
+    std::vector<float>   m_window;          // 周期 Hann 窗
+    std::vector<float>   m_dft_cos;         // [n_bins, n_fft]
+    std::vector<float>   m_dft_sin;
+    std::vector<float>   m_mel_weights;     // 每个梅尔滤波器在 [m_mel_begin, m_mel_end) 上的权重
+    std::vector<int>     m_mel_begin;
+    std::vector<int>     m_mel_end;
+    std::vector<size_t>  m_mel_offset;
+
+    SRC_STATE_tag*       m_resampler;
+    int                  m_input_rate;
+    std::vector<float>   m_samples;         // 重采样后的单声道采样（已丢弃不再需要的头部）
+    int64_t              m_samples_begin;   // m_samples[0] 的绝对位置
+    int64_t              m_total_samples;
+    int64_t              m_next_frame;
+    bool                 m_finished;
+
+    std::vector<float>   m_frame;
+    std::vector<float>   m_power;
+    std::vector<float>   m_log_mel;         // log10 梅尔能量，按帧追加 [n_frames, n_mels]
+};
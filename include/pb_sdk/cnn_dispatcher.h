@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "pb_infer_api.h"
+#include "qm_runtime.h"
+
+/**
+ * @brief 客户端调度返回的附加错误码
+ */
+enum {
+    PBNN_DEADLINE_EXCEEDED = -6000101,      // 请求在截止时间前未完成
+    PBNN_CANCELLED = -6000102,              // 请求被取消
+    PBNN_EXECUTE_FAILED = -6000103,         // 执行抛出异常或返回了非 PBNN 错误码
+};
+
+/**
+ * @brief CNN 请求结果
+ */
+struct CnnRequestResult {
+    uint64_t id = 0;
+    int status = PBNN_SUCCESS;
+    CnnChatCompletions response;
+    double latency_ms = 0.0;                // 从提交到完成的耗时
+};
+
+/**
+ * @brief 有效吞吐统计
+ */
+struct GoodputStats {
+    uint64_t submitted = 0;
+    uint64_t completed_in_deadline = 0;     // 截止时间内完成
+    uint64_t completed_late = 0;            // 完成但已超过截止时间
+    uint64_t expired = 0;                   // 下发前已过期，未占用 NPU
+    uint64_t cancelled = 0;
+    uint64_t failed = 0;
+};
+
+using cnn_result_cb_t = std::function<void(const CnnRequestResult &result)>;
+
+/**
+ * @brief 请求执行函数，在调度线程中调用
+ *
+ * @details 成功时填充 response 并返回 PBNN_SUCCESS，失败时返回 PBNN 错误码
+ */
+using cnn_executor_t = std::function<int(const CnnChatCompletions &request, CnnChatCompletions &response)>;
+
+/**
+ * @brief 带截止时间与取消的 CNN 请求调度器
+ *
+ * @details 请求按提交顺序由单独线程下发，下发前丢弃已过期或已取消的请求；
+ *          已下发的请求无法中断 NPU 执行，取消后其结果被丢弃；析构时未下发的请求以 PBNN_CANCELLED 回调。
+ */
+class CnnDispatcher
+{
+public:
+    CnnDispatcher();
+    ~CnnDispatcher();
+
+    /**
+     * @brief 初始化模型并启动调度线程
+     *
+     * @param [in]model 模型类型
+     * @param [in]model_path 模型pbnn文件路径
+     *
+     * @return 错误码，已初始化成功后再次调用返回 PBNN_INVALID_ARGUMENT
+     */
+    int init(int model, const std::string& model_path);
+
+    /**
+     * @brief 使用指定的执行函数启动调度线程，不加载模型
+     *
+     * @param [in]executor 请求执行函数，为空或已初始化成功时返回 PBNN_INVALID_ARGUMENT
+     *
+     * @return 错误码
+     */
+    int init(cnn_executor_t executor);
+
+    /**
+     * @brief 提交请求
+     *
+     * @param [in]request CNN 请求
+     * @param [in]timeout 相对提交时刻的截止时间
+     * @param [in]callback 结果回调，在调度线程、cancel 调用线程或析构线程中执行；
+     *                     init 未成功时在当前线程以 PBNN_INIT_FAILED 回调
+     *
+     * @return 请求 ID
+     */
+    uint64_t submit(CnnChatCompletions request, std::chrono::milliseconds timeout, cnn_result_cb_t callback);
+
+    /**
+     * @brief 按 ID 取消请求
+     *
+     * @param [in]id 请求 ID
+     *
+     * @return 请求存在且尚未完成返回 true
+     */
+    bool cancel(uint64_t id);
+
+    /**
+     * @brief 获取有效吞吐统计
+     */
+    GoodputStats stats();
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct Pending {
+        uint64_t id;
+        CnnChatCompletions request;
+        clock::time_point submit_time;
+        clock::time_point deadline;
+        cnn_result_cb_t callback;
+    };
+
+    void worker_loop();
+    void finish(const Pending& pending, CnnRequestResult& result);
+
+private:
+    std::unique_ptr<ModelHandler> m_model;
+    cnn_executor_t              m_executor;
+    std::thread                 m_worker;
+    std::mutex                  m_mutex;
+    std::condition_variable     m_cond;
+    std::deque<Pending>         m_queue;
+    // 已下发请求的取消标记
+    std::unordered_map<uint64_t, std::shared_ptr<std::atomic<bool>>> m_inflight;
+    std::atomic<uint64_t>       m_next_id;
+    GoodputStats                m_stats;
+    bool                        m_started;      // init 成功且调度线程已启动
+    bool                        m_stop;
+};
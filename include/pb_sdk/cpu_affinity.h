@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 客户端各角色的 CPU 集合与内存节点配置
+ *
+ * @details 对应 pb_infer.json 中的 "affinity" 段，CPU 集合格式同 taskset，如 "4-5,7"；
+ *          空集合表示不绑核，buffer_node 为 -1 表示不绑定内存节点。
+ */
+struct AffinityConfig {
+    std::vector<int> decode_cpus;       // 图像解码线程
+    std::vector<int> preprocess_cpus;   // 预处理线程
+    std::vector<int> postprocess_cpus;  // 后处理线程
+    int buffer_node = -1;               // 张量缓冲区所在 NUMA 节点
+};
+
+/**
+ * @brief 解析 CPU 列表字符串
+ *
+ * @param [in]cpu_list 形如 "0-3,6" 的字符串
+ *
+ * @return CPU 编号列表，格式错误时抛出 std::invalid_argument
+ */
+std::vector<int> parse_cpu_list(const std::string& cpu_list);
+
+/**
+ * @brief 从配置文件读取 "affinity" 段
+ *
+ * @param [in]config_path 配置文件路径（如 pb_infer.json）
+ *
+ * @return 亲和性配置，文件或字段不存在时返回默认配置
+ */
+AffinityConfig load_affinity_config(const std::string& config_path);
+
+/**
+ * @brief 将当前线程绑定到指定 CPU 集合
+ *
+ * @param [in]cpus CPU 编号列表，为空时不做处理
+ *
+ * @return 成功返回 true
+ */
+bool pin_current_thread(const std::vector<int>& cpus);
+
+/**
+ * @brief 启动时检查 CPU 集合是否可用且已隔离（isolcpus），不满足时打印告警
+ *
+ * @param [in]role 角色名，用于告警信息
+ * @param [in]cpus CPU 编号列表
+ *
+ * @return 全部 CPU 可用且已隔离返回 true
+ */
+bool verify_cpu_isolation(const std::string& role, const std::vector<int>& cpus);
+
+/**
+ * @brief 将已分配的内存绑定到指定 NUMA 节点（首次访问前调用）
+ *
+ * @details 通过 mbind(MPOL_BIND | MPOL_MF_MOVE) 绑定，只作用于完全落在 [addr, addr + size) 内的整页；
+ *          需要整块绑定时使用页对齐的内存（如 NodeBufferPool）。
+ *
+ * @param [in]addr 内存起始地址
+ * @param [in]size 内存字节数
+ * @param [in]node NUMA 节点，<0 时不做处理
+ *
+ * @return 成功返回 true；内存不足一整页、节点无效或系统不支持 NUMA 时返回 false
+ */
+bool bind_to_node(void* addr, size_t size, int node);
+
+/**
+ * @brief 绑定到 NUMA 节点的定长缓冲区池，线程安全
+ *
+ * @details 缓冲区按页对齐 mmap 并整块 mbind 到 node，释放时回到空闲列表复用，避免每帧 mmap 与缺页。
+ *          acquire 返回的缓冲区可以比池对象活得更久；node <0 或绑定失败时仍返回普通页对齐缓冲区。
+ */
+class NodeBufferPool
+{
+public:
+    /**
+     * @param [in]block_size 单个缓冲区字节数，向上取整到页大小
+     * @param [in]node NUMA 节点，<0 表示不绑定
+     */
+    NodeBufferPool(size_t block_size, int node);
+
+    /**
+     * @brief 获取一个缓冲区，引用计数归零时自动归还
+     *
+     * @return 缓冲区，mmap 失败时返回空指针
+     */
+    std::shared_ptr<void> acquire();
+
+    size_t block_size() const;
+    int node() const;
+
+private:
+    struct State;
+    std::shared_ptr<State> m_state;
+};
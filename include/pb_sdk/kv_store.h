@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "pb_infer_api.h"
+#include "token_radix_tree.h"
+
+/**
+ * @brief KV 前缀文件头，所有数据段按 kKvFileAlignment 对齐
+ *
+ * @details 文件布局：
+ *          [头][token_ids (int32)][层表: 每层 k_offset, k_count, v_offset, v_count (uint64)][k0][v0][k1][v1]...
+ */
+struct KvFileHeader {
+    char magic[8];                  // "PBKVSTR1"
+    uint32_t version;
+    uint32_t num_layers;
+    uint64_t prefix_hash;
+    uint64_t num_tokens;
+    uint64_t token_offset;
+    uint64_t table_offset;
+    uint64_t file_size;
+};
+
+constexpr size_t kKvFileAlignment = 4096;
+
+/**
+ * @brief 只读映射的 KV 前缀文件，各层数据直接指向映射内存
+ */
+class MappedPrefixCache
+{
+public:
+    ~MappedPrefixCache();
+
+    MappedPrefixCache(const MappedPrefixCache&) = delete;
+    MappedPrefixCache& operator=(const MappedPrefixCache&) = delete;
+
+    /**
+     * @brief 映射文件并校验头部与各段范围
+     *
+     * @return 失败返回空指针
+     */
+    static std::shared_ptr<MappedPrefixCache> open(const std::string& path);
+
+    const KvFileHeader& header() const { return *m_header; }
+    size_t num_layers() const { return m_header->num_layers; }
+    size_t num_tokens() const { return m_header->num_tokens; }
+    const int32_t* token_ids() const;
+    const uint16_t* k_data(size_t layer) const;
+    const uint16_t* v_data(size_t layer) const;
+    size_t k_count(size_t layer) const;
+    size_t v_count(size_t layer) const;
+
+    /**
+     * @brief 转为 load_kv_cache 需要的 PrefixCache，每层一次连续拷贝
+     */
+    PrefixCache to_prefix_cache() const;
+
+private:
+    MappedPrefixCache() = default;
+
+    const uint64_t* layer_entry(size_t layer) const;
+
+private:
+    void*                   m_addr = nullptr;
+    size_t                  m_size = 0;
+    const KvFileHeader*     m_header = nullptr;
+};
+
+/**
+ * @brief KV 前缀存储统计
+ */
+struct KvStoreStats {
+    uint64_t ram_hits = 0;
+    uint64_t disk_hits = 0;
+    uint64_t misses = 0;
+    uint64_t ram_evictions = 0;
+    uint64_t disk_evictions = 0;
+    size_t ram_entries = 0;
+    size_t ram_bytes = 0;
+    size_t disk_entries = 0;
+    size_t disk_bytes = 0;
+    uint64_t prompt_tokens = 0;         // 参与前缀匹配的 prompt token 总数
+    uint64_t reused_tokens = 0;         // 其中由已存储前缀覆盖、无需 prefill 的 token 数
+
+    double savings_ratio() const { return prompt_tokens == 0 ? 0.0 : static_cast<double>(reused_tokens) / prompt_tokens; }
+};
+
+/**
+ * @brief 持久化的分层 KV 前缀存储
+ *
+ * @details 以 token 前缀哈希为键。写入时同时落盘（写临时文件并 fsync 后 rename，再 fsync 目录），并放入内存层；
+ *          内存层按字节预算 LRU 淘汰（仍保留在磁盘），磁盘层超出预算时删除最久未使用的文件。
+ *          磁盘命中时在锁外 mmap 文件并按层拷贝进 PrefixCache，随后提升到内存层。
+ *          进程重启后扫描目录，只用 pread 读取文件头与 token 序列重建磁盘索引，并删除写入进程已退出的遗留临时文件。
+ */
+class KvPrefixStore
+{
+public:
+    /**
+     * @param [in]dir 存储目录，不存在时创建
+     * @param [in]ram_budget_bytes 内存层字节预算
+     * @param [in]disk_budget_bytes 磁盘层字节预算
+     */
+    KvPrefixStore(const std::string& dir, size_t ram_budget_bytes, size_t disk_budget_bytes);
+
+    /**
+     * @brief token 前缀的 64 位哈希
+     */
+    static uint64_t prefix_hash(const int* token_ids, size_t count);
+
+    /**
+     * @brief 按对齐格式写出单个前缀文件
+     *
+     * @return 成功返回 true
+     */
+    static bool write_file(const std::string& path, const PrefixCache& cache);
+
+    /**
+     * @brief 保存前缀（通常为 save_kv_cache 的结果）
+     */
+    bool put(const PrefixCache& cache);
+
+    /**
+     * @brief 按完整 token 序列精确查找
+     *
+     * @return 未命中返回空指针
+     */
+    std::shared_ptr<const PrefixCache> get(const std::vector<int>& token_ids);
+
+    /**
+     * @brief 查找 token_ids 的最长已存储前缀，并计入 prefill 节省统计
+     */
+    std::shared_ptr<const PrefixCache> match_longest(const std::vector<int>& token_ids);
+
+    /**
+     * @brief 查找最长前缀并通过 load_kv_cache 装载到引擎
+     *
+     * @param [in]prompt_tokens 即将发送的 prompt 的 token 序列
+     *
+     * @return 已装载的前缀 token 数，未命中返回 0
+     */
+    size_t restore(const std::vector<int>& prompt_tokens);
+
+    KvStoreStats stats();
+
+private:
+    struct RamEntry {
+        uint64_t hash;
+        std::shared_ptr<const PrefixCache> cache;
+        size_t bytes;
+    };
+
+    struct DiskEntry {
+        std::string path;
+        size_t bytes;
+        std::vector<int> token_ids;
+        uint64_t last_use;
+    };
+
+    std::string path_for(uint64_t hash) const;
+    std::shared_ptr<const PrefixCache> lookup(uint64_t hash, const int* token_ids, size_t count);
+    void insert_ram_locked(uint64_t hash, std::shared_ptr<const PrefixCache> cache);
+    void evict_disk_locked();
+    void forget_locked(uint64_t hash, const std::vector<int>& token_ids);
+    void scan_dir();
+
+private:
+    std::string                 m_dir;
+    size_t                      m_ram_budget;
+    size_t                      m_disk_budget;
+    std::mutex                  m_mutex;
+    std::list<RamEntry>         m_ram_lru;      // 头部为最近使用
+    std::unordered_map<uint64_t, std::list<RamEntry>::iterator> m_ram_index;
+    std::unordered_map<uint64_t, DiskEntry> m_disk_index;
+    TokenRadixTree              m_tree;         // 任一层中存在的前缀，用于最长前缀匹配
+    uint64_t                    m_clock = 0;
+    KvStoreStats                m_stats;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "pb_infer_api.h"
+#include "qm_runtime.h"
+
+/**
+ * @brief 张量描述
+ */
+struct TensorDesc {
+    std::string name;
+    std::vector<int64_t> shape;     // 逻辑形状（NCHW）
+    std::string data_type;          // 与 CnnChatData::data_type 一致，如 "float16"、"uint8_t"
+    std::string layout;             // NPU 原生内存布局，如 "NHWC"，空表示与逻辑形状一致
+    float scale = 1.0f;             // 量化参数：real = (q - zero_point) * scale
+    int zero_point = 0;
+
+    /**
+     * @brief 按形状与数据类型计算字节数
+     */
+    size_t nbytes() const;
+};
+
+/**
+ * @brief 模型描述
+ */
+struct ModelDesc {
+    int model = 0;
+    std::string name;
+    std::vector<TensorDesc> inputs;
+    std::vector<TensorDesc> outputs;
+    int max_batch = 1;
+};
+
+/**
+ * @brief 查询模型输入输出描述，不需要加载模型
+ *
+ * @param [in]model 模型类型
+ *
+ * @return 模型描述，未注册的模型返回 std::nullopt
+ */
+std::optional<ModelDesc> describe_model(int model);
+
+/**
+ * @brief 注册或覆盖模型描述（如转换后输入类型改为 uint8 的模型）
+ *
+ * @param [in]desc 模型描述
+ */
+void register_model_desc(const ModelDesc& desc);
+
+/**
+ * @brief 按数据类型名获取单个元素字节数
+ *
+ * @param [in]data_type 数据类型名
+ *
+ * @return 元素字节数，未知类型返回 0
+ */
+size_t data_type_size(const std::string& data_type);
+
+/**
+ * @brief 在发送到服务器之前校验 CNN 请求的输入个数、形状与数据长度
+ *
+ * @param [in]desc 模型描述
+ * @param [in]request CNN 请求
+ * @param [out]error 校验失败原因
+ *
+ * @return 错误码，校验通过返回 PBNN_SUCCESS
+ */
+int validate_request(const ModelDesc& desc, const CnnChatCompletions& request, std::string* error = nullptr);
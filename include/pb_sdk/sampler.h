@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "pb_infer_api.h"
+
+/**
+ * @brief 采样参数
+ */
+struct SamplerConfig {
+    float temperature = 1.0f;           // <=0 时为贪心
+    int top_k = 50;                     // <=0 表示不限制
+    int meta_top_k = 100;               // 候选集合上限，top-p 与 min-p 在其中计算，<=0 表示不限制
+    float top_p = 1.0f;
+    float min_p = 0.0f;                 // 丢弃概率低于 min_p * 最大概率的 token，0 表示关闭
+    float repetition_penalty = 1.0f;
+    float presence_penalty = 0.0f;
+    float frequency_penalty = 0.0f;
+    std::optional<int> seed;            // 设置后结果可复现
+
+    /**
+     * @brief 从请求参数构造
+     */
+    static SamplerConfig from_request(const ChatCompletionsRequest& request);
+};
+
+/**
+ * @brief 单序列 token 采样器
+ *
+ * @details 惩罚项只作用于已出现的 token（按计数表），不做全词表遍历：repetition penalty 作用于 prompt
+ *          与已生成 token，presence/frequency penalty 与 OpenAI 一致只统计已生成 token。
+ *          top-k 先用 12 位基数直方图找出第 k 大所在桶，只收集该桶及以上的候选再做 nth_element；
+ *          不限 top-k 时按 min-p 换算出的 logit 下限与按桶累加的概率质量（top-p）截断，
+ *          只对截断后的候选排序。softmax、top-p 与 min-p 只在候选集合上计算。非线程安全。
+ */
+class TokenSampler
+{
+public:
+    TokenSampler(int vocab_size, const SamplerConfig& config);
+
+    /**
+     * @brief 清空已出现 token 计数，开始新序列
+     */
+    void reset();
+
+    /**
+     * @brief 记录一个 prompt token，只参与 repetition penalty
+     */
+    void accept_prompt(int token);
+
+    /**
+     * @brief 记录一个已生成 token，参与全部惩罚项
+     */
+    void accept(int token);
+
+    /**
+     * @brief 采样下一个 token
+     *
+     * @param [in,out]logits 长度为 vocab_size 的 logits，惩罚项原地修改
+     *
+     * @return 采样得到的 token
+     */
+    int sample(float* logits);
+
+    /**
+     * @brief 采样并记录到计数表
+     */
+    int sample_and_accept(float* logits);
+
+    int vocab_size() const { return m_vocab_size; }
+
+private:
+    struct Candidate {
+        float logit;
+        int token;
+    };
+
+    void apply_penalties(float* logits) const;
+    void select_top_k(const float* logits, int k);
+    float select_by_mass(const float* logits);
+    void mark_seen(int token);
+    double next_uniform();
+
+private:
+    int                     m_vocab_size;
+    SamplerConfig           m_config;
+    std::vector<int>        m_counts;       // 每个 token 在已生成序列中的出现次数
+    std::vector<uint8_t>    m_seen_flag;    // 是否出现在 prompt 或已生成序列中
+    std::vector<int>        m_seen;         // 出现过的 token，惩罚只遍历这些
+    std::vector<uint32_t>   m_histogram;
+    std::vector<float>      m_mass;         // 按桶累加的未归一化概率，用于 top-p 截断
+    std::vector<Candidate>  m_candidates;
+    std::vector<float>      m_probs;
+    std::mt19937_64         m_rng;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "pb_infer_api.h"
+#include "spsc_ring.h"
+
+/**
+ * @brief 流式投递参数
+ */
+struct StreamDeliveryConfig {
+    size_t ring_capacity = 256;                                 // 每个请求的事件环容量
+};
+
+/**
+ * @brief 流式投递统计
+ */
+struct StreamDeliveryStats {
+    uint64_t events = 0;                // 生产端收到的 chunk 数
+    uint64_t delivered = 0;             // 实际调用回调的次数
+    uint64_t overflowed = 0;            // 环满时进入溢出队列的事件数
+};
+
+/**
+ * @brief 单个流式请求的解耦投递
+ *
+ * @details 读取 ModelHandler 输出的线程通过 producer() 返回的回调提交 chunk，只做无锁入队，
+ *          从不等待用户回调；仅含文本增量的 chunk 以紧凑的文本事件入队。
+ *          投递线程空闲时阻塞在条件变量上，有事件即被唤醒并立即投递；只有回调慢于生成、
+ *          环中积压了多个事件时，才把连续的文本增量合并为一个 chunk，合并后的 chunk 携带最后一个增量的
+ *          usage、metric 与 created。带 role、finish_reason 等字段的 chunk 原样投递，顺序不变。
+ *          环满时生产端把事件追加到环后的溢出队列（相邻文本合并），由投递线程在取空环后接着取走，
+ *          因此慢回调不会阻塞生成，溢出的文本也不依赖下一次 push 才能送达。
+ */
+class StreamDelivery
+{
+public:
+    StreamDelivery(stream_cb_t callback, const StreamDeliveryConfig& config = StreamDeliveryConfig());
+    ~StreamDelivery();
+
+    StreamDelivery(const StreamDelivery&) = delete;
+    StreamDelivery& operator=(const StreamDelivery&) = delete;
+
+    /**
+     * @brief 生产端回调，只能在一个线程中调用，生命周期不得超过本对象
+     */
+    stream_cb_t producer();
+
+    /**
+     * @brief 生产端结束：补发暂存事件，等待投递线程处理完所有事件后返回
+     */
+    void close();
+
+    /**
+     * @brief 统计数据，close 之后读取
+     */
+    StreamDeliveryStats stats() const;
+
+private:
+    struct Event {
+        std::string text;                                   // 文本增量
+        Usage usage{};                                      // 文本增量所在 chunk 的 usage、metric 与 created
+        Metric metric{};
+        time_t created = 0;
+        std::unique_ptr<ChatCompletionChunkObject> chunk;   // 非空时原样投递
+    };
+
+    void push(const ChatCompletionChunkObject& chunk);
+    void wake();
+    bool has_work() const;
+    void delivery_loop();
+    void handle(Event& event, Event& pending);
+    void deliver_text(Event& pending);
+
+private:
+    stream_cb_t                 m_callback;
+    StreamDeliveryConfig        m_config;
+    SpscRing<Event>             m_ring;
+
+    // 生产端状态
+    bool                        m_header_sent = false;
+    bool                        m_closed = false;
+    uint64_t                    m_events = 0;
+    uint64_t                    m_overflowed = 0;
+
+    // 溢出队列排在环之后：非空期间生产端不再写环，只有投递线程把它取空
+    std::mutex                  m_mutex;
+    std::condition_variable     m_cv;
+    std::deque<Event>           m_overflow;
+    std::atomic<bool>           m_overflow_pending{false};
+    std::atomic<bool>           m_sleeping{false};
+
+    // 投递端状态
+    ChatCompletionChunkObject   m_template;         // 最近一个完整 chunk 的 id、model 等字段
+    uint64_t                    m_delivered = 0;
+
+    std::atomic<bool>           m_producer_done{false};
+    std::thread                 m_thread;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "pb_infer_api.h"
+
+/**
+ * @brief 单个流式请求的延迟统计（毫秒）
+ */
+struct StreamLatencyReport {
+    size_t chunks = 0;                  // 收到的全部 chunk，含只带 role 或 finish_reason 的 chunk
+    size_t content_chunks = 0;          // delta.content 非空的 chunk
+    double ttft_ms = 0.0;               // 请求发出到首个 delta.content 非空的 chunk
+    double itl_p50_ms = 0.0;            // 相邻内容 chunk 间隔（inter-token latency）的最近秩分位数
+    double itl_p90_ms = 0.0;
+    double itl_p99_ms = 0.0;
+    double itl_max_ms = 0.0;            // 最大间隔，反映长 prefill 造成的停顿
+    double total_ms = 0.0;              // 请求发出到最后一个 chunk
+};
+
+/**
+ * @brief 流式请求的 TTFT 与 chunk 间隔记录
+ *
+ * @details Metric 为服务端定义的结构，不含 TTFT 与间隔分位数，这里在客户端按 chunk 到达时刻统计。
+ *          首个 chunk 通常只带 role，不计入 TTFT 与间隔。一个实例对应一个请求，非线程安全。
+ */
+class StreamLatencyRecorder
+{
+public:
+    /**
+     * @brief 标记请求发出时刻，清空之前的记录
+     */
+    void start();
+
+    /**
+     * @brief 记录一个 chunk 的到达时刻
+     */
+    void on_chunk(const ChatCompletionChunkObject& chunk);
+
+    /**
+     * @brief 包装流式回调，在转发前记录到达时刻
+     *
+     * @param [in]callback 原回调，可为空
+     *
+     * @return 包装后的回调，生命周期不得超过本对象
+     */
+    stream_cb_t wrap(stream_cb_t callback);
+
+    /**
+     * @brief 计算统计结果，start() 未调用时返回全 0
+     */
+    StreamLatencyReport report() const;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    clock::time_point               m_start;
+    clock::time_point               m_last;             // 最后一个 chunk 的到达时刻
+    size_t                          m_chunks = 0;
+    std::vector<clock::time_point>  m_arrivals;         // 内容 chunk 的到达时刻
+    bool                            m_started = false;
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 固定线程数的简单线程池，用于客户端前后处理并行
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief 创建线程池
+     *
+     * @param [in]thread_nums 工作线程数，<=0 时使用硬件并发数
+     * @param [in]on_start 工作线程启动时在该线程内调用（如绑核），参数为线程序号
+     */
+    explicit ThreadPool(int thread_nums = 0, std::function<void(int)> on_start = nullptr)
+    {
+        if (thread_nums <= 0) {
+            thread_nums = std::max(1u, std::thread::hardware_concurrency());
+        }
+        m_workers.reserve(thread_nums);
+        for (int i = 0; i < thread_nums; ++i) {
+            m_workers.emplace_back([this, i, on_start] {
+                if (on_start) {
+                    on_start(i);
+                }
+                worker_loop();
+            });
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cond.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief 提交任务
+     *
+     * @param [in]func 任务函数
+     * @return 任务结果的 future
+     */
+    template <typename F>
+    auto submit(F&& func) -> std::future<std::invoke_result_t<F>>
+    {
+        using R = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(func));
+        std::future<R> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.emplace([task] { (*task)(); });
+        }
+        m_cond.notify_one();
+        return result;
+    }
+
+    size_t size() const { return m_workers.size(); }
+
+private:
+    void worker_loop()
+    {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cond.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+                if (m_stop && m_tasks.empty()) {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop();
+            }
+            task();
+        }
+    }
+
+private:
+    std::vector<std::thread>          m_workers;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex                        m_mutex;
+    std::condition_variable           m_cond;
+    bool                              m_stop = false;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief token 序列的压缩前缀树（radix tree）
+ *
+ * @details 记录已存储的 token 前缀，按 prompt 一次遍历找到最长的已存储前缀，
+ *          代价与 prompt 长度成正比，与已存储前缀的数量无关。非线程安全。
+ */
+class TokenRadixTree
+{
+public:
+    TokenRadixTree();
+
+    /**
+     * @brief 插入前缀，已存在时不做处理
+     */
+    void insert(const int* tokens, size_t count);
+
+    /**
+     * @brief 删除前缀并合并不再需要的节点
+     *
+     * @return 前缀存在返回 true
+     */
+    bool erase(const int* tokens, size_t count);
+
+    /**
+     * @brief 查找 tokens 的最长已存储前缀
+     *
+     * @return 最长前缀长度，无匹配返回 0
+     */
+    size_t longest_match(const int* tokens, size_t count) const;
+
+    /**
+     * @brief 已存储前缀数
+     */
+    size_t size() const { return m_size; }
+
+    void clear();
+
+private:
+    struct Node {
+        std::vector<int> edge;          // 从父节点到本节点的 token 段
+        bool terminal = false;          // 根到本节点的路径是否为已存储前缀
+        std::unordered_map<int, std::unique_ptr<Node>> children;
+    };
+
+    static bool erase_from(Node& node, const int* tokens, size_t count);
+
+private:
+    std::unique_ptr<Node>   m_root;
+    size_t                  m_size;
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "pb_infer_api.h"
+#include "thread_pool.h"
+#include "vl_preprocess.h"
+
+/**
+ * @brief 视频采样与去重参数
+ */
+struct VideoIngestConfig {
+    float fps = 1.0f;                   // 采样帧率，与 ChatCompletionsRequest::fps 一致
+    int max_frames = 0;                 // 采样帧数上限，0 表示不限制
+    int model = QWEN_2_5VL_7B;          // 决定 pixel_data 打包方式的 VL 模型，需为 smart_resize 模型
+    int max_pixels = 448 * 448;         // 每帧 smart_resize 的像素上限，保持宽高比
+    int hash_distance = 4;              // dHash 汉明距离不超过该值时视为疑似重复
+    double sad_threshold = 3.0;         // 缩略图平均绝对差（0~255）不超过该值时确认重复
+    double seek_gap_ms = 1000.0;        // 相邻采样点间隔不超过该值时顺序 grab，不做 seek
+    int thread_nums = 0;                // 解码线程数，<=0 时使用硬件并发数
+    std::vector<int> cpus;              // 解码线程绑定的 CPU 集合，为空时不绑核
+};
+
+/**
+ * @brief 采样得到的视频帧
+ */
+struct VideoFrame {
+    double timestamp_ms = 0.0;          // 采样时间点
+    cv::Mat image;                      // RGB，按 smart_resize 保持宽高比缩放，解码失败时为空
+    uint64_t hash = 0;                  // 64 位 dHash
+    cv::Mat thumb;                      // 32x32 灰度缩略图，用于 SAD 确认
+};
+
+/**
+ * @brief 单个视频的采样统计
+ */
+struct VideoIngestStats {
+    int sampled = 0;                    // 采样时间点数
+    int decoded = 0;                    // 成功解码的帧数
+    int kept = 0;                       // 去重后保留的帧数
+    int dropped = 0;                    // 判定为重复而丢弃的帧数
+    double decode_ms = 0.0;             // 并行 seek 解码耗时
+    double dedup_ms = 0.0;              // 去重耗时
+};
+
+/**
+ * @brief 视频采样结果
+ */
+struct VideoIngestResult {
+    std::vector<VideoFrame> frames;     // 去重后保留的帧，按时间排序
+    VlPixelData pixel;                  // 保留帧经 VlPreprocessor::preprocess_video 打包的 patch 数据与 grid_thw
+    VideoIngestStats stats;
+};
+
+/**
+ * @brief VL 模型的视频输入采样
+ *
+ * @details 按 fps 计算采样时间点，线程池中每个线程打开独立的 VideoCapture，
+ *          只 seek 到分配给自己的时间点解码；之后按时间顺序与上一保留帧比较，
+ *          dHash 相近且缩略图 SAD 足够小的帧被丢弃，不再送入视觉编码器。
+ *          解码线程直接把帧缩放到 smart_resize 尺寸，保留帧由 VlPreprocessor 按模型的 patch 布局打包。
+ */
+class VideoIngest
+{
+public:
+    /**
+     * @param [in]config 采样参数，config.model 不是 smart_resize 模型时抛出 std::invalid_argument
+     */
+    explicit VideoIngest(const VideoIngestConfig& config = VideoIngestConfig());
+
+    /**
+     * @brief 计算采样时间点，取每个采样区间的中点
+     *
+     * @param [in]duration_ms 视频时长
+     * @param [in]fps 采样帧率
+     * @param [in]max_frames 帧数上限，超过时在全片均匀取点，0 表示不限制
+     *
+     * @return 采样时间点（毫秒）
+     */
+    static std::vector<double> sample_timestamps(double duration_ms, float fps, int max_frames);
+
+    /**
+     * @brief 计算图像的 64 位差值哈希（9x8 灰度，相邻像素比较）
+     */
+    static uint64_t dhash(const cv::Mat& image);
+
+    /**
+     * @brief 按时间顺序去除与上一保留帧近似重复的帧
+     *
+     * @param [in]frames 按时间排序的帧，image 为空的帧直接跳过
+     * @param [in]hash_distance dHash 汉明距离不超过该值时视为疑似重复
+     * @param [in]sad_threshold 疑似重复帧的缩略图平均绝对差不超过该值时丢弃
+     *
+     * @return 保留的帧
+     */
+    static std::vector<VideoFrame> prune_duplicates(std::vector<VideoFrame> frames, int hash_distance,
+                                                    double sad_threshold);
+
+    /**
+     * @brief 采样、去重并打包一个视频
+     *
+     * @param [in]path 视频文件路径或 OpenCV 支持的 URL
+     *
+     * @return 采样结果，打开失败时 frames 为空
+     */
+    VideoIngestResult ingest(const std::string& path);
+
+    /**
+     * @brief 生成视频 ContentPart，保留帧的打包数据放入 pixel_data
+     *
+     * @details ContentPart 没有 grid_thw 字段，pixel_data 的行数 grid_t * grid_h * grid_w 也无法唯一反推出网格；
+     *          去重后帧数与按 fps 采样的帧数不同，服务端按 part.video 自行采样得到的网格同样对不上。
+     *          因此输出只是 VlPreprocessor 的客户端打包结果，并不保证是引擎可直接使用的布局，
+     *          网格以 result.pixel 的 grid_t/grid_h/grid_w 为准，需要由调用方另行传给服务端。
+     */
+    static ContentPart to_content_part(const std::string& path, const VideoIngestResult& result);
+
+    /**
+     * @brief 按实测视觉编码耗时估算去重节省的时间
+     *
+     * @param [in]metric 送入去重后帧的请求返回的性能数据
+     * @param [in]stats 该视频的采样统计
+     *
+     * @return 估算节省的视觉编码时间，单位与 Metric::ve_time 相同
+     */
+    static double estimate_ve_saved(const Metric& metric, const VideoIngestStats& stats);
+
+private:
+    /**
+     * @brief 在当前线程顺序解码一段时间点
+     */
+    std::vector<VideoFrame> decode_segment(const std::string& path, const std::vector<double>& timestamps) const;
+
+private:
+    VideoIngestConfig              m_config;
+    VlPreprocessor                 m_preprocessor;
+    std::unique_ptr<ThreadPool>    m_pool;
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "pb_infer_api.h"
+#include "thread_pool.h"
+
+/**
+ * @brief VL 模型的缩放方式
+ */
+enum class VlResizeMode {
+    SMART_RESIZE,       // 保持宽高比缩放到 patch_size * merge_size 的整数倍（Qwen2.5-VL）
+    FIXED,              // 缩放到 image_size x image_size（PaliGemma）
+    DYNAMIC_TILES,      // 按最接近的宽高比切成 image_size 的块，附加缩略图（InternVL3）
+};
+
+/**
+ * @brief VL 模型的预处理参数
+ */
+struct VlPreprocessParams {
+    int model = 0;
+    VlResizeMode mode = VlResizeMode::SMART_RESIZE;
+    int patch_size = 14;
+    int merge_size = 2;
+    int temporal_patch_size = 2;
+    int min_pixels = 56 * 56;
+    int max_pixels = 28 * 28 * 1280;
+    int image_size = 448;               // FIXED 的边长 / DYNAMIC_TILES 的块边长
+    int min_tiles = 1;
+    int max_tiles = 12;
+    bool use_thumbnail = true;
+    std::array<float, 3> mean{0.48145466f, 0.4578275f, 0.40821073f};   // RGB
+    std::array<float, 3> stddev{0.26862954f, 0.26130258f, 0.27577711f};
+};
+
+/**
+ * @brief 打包后的 pixel_data
+ */
+struct VlPixelData {
+    std::vector<uint16_t> pixel_data;   // float16
+    std::vector<int64_t> shape;         // SMART_RESIZE: [grid_t * grid_h * grid_w, 3 * T * P * P]；其余: [N, 3, H, W]
+    int grid_t = 1;                     // SMART_RESIZE 时对应 grid_thw，以 patch 为单位
+    int grid_h = 0;
+    int grid_w = 0;
+    cv::Size resized;                   // 缩放后尺寸（DYNAMIC_TILES 为拼接后的整图尺寸）
+    double preprocess_ms = 0.0;         // 客户端预处理耗时，与服务端 Metric 分开统计
+};
+
+/**
+ * @brief 查询 VL 模型的预处理参数
+ *
+ * @param [in]model 模型类型
+ *
+ * @return 非 VL 模型返回 std::nullopt
+ */
+std::optional<VlPreprocessParams> vl_preprocess_params(int model);
+
+/**
+ * @brief VL 模型图像/视频预处理
+ *
+ * @details 缩放后逐像素查表完成 /255 与 mean/std 归一化并直接写成 float16，
+ *          按模型要求的 patch（含时间维）顺序打包；批量输入在线程池中按图像并行。
+ */
+class VlPreprocessor
+{
+public:
+    /**
+     * @param [in]params 预处理参数，通常由 vl_preprocess_params 获得
+     * @param [in]thread_nums 线程数，<=0 时使用硬件并发数
+     * @param [in]cpus 工作线程绑定的 CPU 集合，为空时不绑核
+     */
+    explicit VlPreprocessor(const VlPreprocessParams& params, int thread_nums = 0, const std::vector<int>& cpus = {});
+
+    /**
+     * @brief Qwen2.5-VL smart_resize：保持宽高比，边长取 factor 的整数倍，像素数落在 [min_pixels, max_pixels]
+     *
+     * @return 缩放后尺寸
+     */
+    static cv::Size smart_resize(int height, int width, int factor, int min_pixels, int max_pixels);
+
+    /**
+     * @brief 近似 PIL BICUBIC（带抗锯齿）的缩放
+     *
+     * @details cv::INTER_CUBIC 缩小时不抗锯齿，高频纹理会产生混叠；缩小超过 2 倍时先 INTER_AREA
+     *          降到目标尺寸的 2 倍，再 INTER_CUBIC 到目标尺寸。与 PIL 的差异集中在强纹理处，
+     *          自然图像上通常在 1~2 个灰度级以内；放大与 2 倍以内的缩小直接使用 INTER_CUBIC。
+     */
+    static cv::Mat resize(const cv::Mat& src, const cv::Size& size);
+
+    /**
+     * @brief 预处理单张 BGR 图像
+     */
+    VlPixelData preprocess(const cv::Mat& bgr) const;
+
+    /**
+     * @brief 预处理视频帧序列，仅 SMART_RESIZE 模型支持，帧数不足 temporal_patch_size 整数倍时重复最后一帧
+     *
+     * @param [in]frames 同尺寸的帧
+     * @param [in]is_rgb 帧为 RGB（如 VideoIngest 输出）时为 true，BGR 时为 false
+     */
+    VlPixelData preprocess_video(const std::vector<cv::Mat>& frames, bool is_rgb = false) const;
+
+    /**
+     * @brief 并行预处理一批 BGR 图像
+     *
+     * @return 与输入顺序一致的结果
+     */
+    std::vector<VlPixelData> preprocess_batch(const std::vector<cv::Mat>& images);
+
+    /**
+     * @brief 生成图像 ContentPart
+     */
+    static ContentPart to_content_part(const std::string& url, const VlPixelData& data);
+
+    /**
+     * @brief 客户端预处理总耗时（毫秒）
+     *
+     * @details Metric::preprocess_time 是服务端返回的数据，客户端耗时单独上报，不写入 Metric。
+     */
+    static double total_preprocess_ms(const std::vector<VlPixelData>& results);
+
+    const VlPreprocessParams& params() const { return m_params; }
+
+private:
+    void pack_patches(const std::vector<cv::Mat>& frames, bool is_rgb, VlPixelData& out) const;
+    void pack_chw(const std::vector<cv::Mat>& images, VlPixelData& out) const;
+    std::vector<cv::Mat> dynamic_tiles(const cv::Mat& bgr, cv::Size& resized) const;
+
+private:
+    VlPreprocessParams              m_params;
+    std::array<std::array<uint16_t, 256>, 3> m_lut;    // RGB 通道的 u8 -> 归一化 float16
+    std::unique_ptr<ThreadPool>     m_pool;
+};
@@ -0,0 +1,126 @@
+/**
+ * @file image_ingest.h
+ * @brief 图像解码类，用于 YOLOv8 模型输入
+ * @details 根据模型输入尺寸选择 JPEG DCT 缩放解码比例（1/2、1/4、1/8），
+ *          支持文件路径与内存编码数据输入，支持线程池并行解码并直接送入预处理。
+ *          缩放解码得到的图像只用于预处理，检测结果需按 src_size 还原到原图坐标。
+ */
+#ifndef ADAS_MONOREPO_MODULES_PERCEPTION_CAMERA_DETECTION_GESTURE_DETECTOR_YOLOV8S_IMAGE_INGEST_H
+#define ADAS_MONOREPO_MODULES_PERCEPTION_CAMERA_DETECTION_GESTURE_DETECTOR_YOLOV8S_IMAGE_INGEST_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+#include <torch/torch.h>
+
+#include "pb_sdk/cpu_affinity.h"
+#include "pb_sdk/thread_pool.h"
+#include "preprocess.h"
+
+/**
+ * @brief 解码结果
+ */
+struct DecodedImage {
+    cv::Mat image;          // 解码后的图像（BGR 格式），失败时为空
+    cv::Size src_size;      // 编码图像的原始尺寸
+    int scale_denom = 1;    // DCT 缩放分母：1、2、4、8
+};
+
+/**
+ * @brief 解码并预处理的结果
+ */
+struct IngestResult {
+    DecodedImage decoded;
+    torch::Tensor tensor;   // 预处理输出，形状为 [1, 3, H, W] 的 Float16 张量
+};
+
+class ImageIngest {
+    public:
+    /**
+     * @brief 构造函数
+     * @param imgsz 模型输入尺寸（通常为 640）
+     * @param thread_nums 批量解码的线程数，<=0 时使用硬件并发数；线程池在首次调用 ingest_batch 时创建
+     * @param cpus 解码线程绑定的 CPU 集合，为空时不绑核
+     * @param buffer_node 预处理输出缓冲区所在 NUMA 节点，<0 时由 torch 分配
+     */
+    explicit ImageIngest(int imgsz = 640, int thread_nums = 0, const std::vector<int>& cpus = {},
+                         int buffer_node = -1);
+
+    /**
+     * @brief 解析 JPEG 头获取图像尺寸，不做解码
+     * @param data 编码数据
+     * @param len 编码数据长度
+     * @param size 输出图像尺寸
+     * @return 是否为可解析的 JPEG
+     */
+    static bool probe_jpeg_size(const uint8_t* data, size_t len, cv::Size& size);
+
+    /**
+     * @brief 选择 DCT 缩放分母，保证缩放后长边不小于 imgsz
+     * @param src_size 原始图像尺寸
+     * @param imgsz 模型输入尺寸
+     * @return 缩放分母：1、2、4、8
+     */
+    static int select_scale(const cv::Size& src_size, int imgsz);
+
+    /**
+     * @brief 从文件解码
+     * @param image_path 图像路径
+     * @return 解码结果
+     */
+    DecodedImage decode(const std::string& image_path) const;
+
+    /**
+     * @brief 从内存编码数据解码（如网络传输的 JPEG 帧）
+     * @param data 编码数据
+     * @param len 编码数据长度
+     * @return 解码结果
+     */
+    DecodedImage decode(const uint8_t* data, size_t len) const;
+    DecodedImage decode(const std::vector<uint8_t>& buffer) const;
+
+    /**
+     * @brief 并行解码并预处理一批图像文件
+     * @param image_paths 图像路径列表
+     * @return 与输入顺序一致的结果列表，解码失败的项 tensor 为空
+     */
+    std::vector<IngestResult> ingest_batch(const std::vector<std::string>& image_paths);
+
+    /**
+     * @brief 并行解码并预处理一批内存编码数据
+     * @param buffers 编码数据列表
+     * @return 与输入顺序一致的结果列表，解码失败的项 tensor 为空
+     */
+    std::vector<IngestResult> ingest_batch(const std::vector<std::vector<uint8_t>>& buffers);
+
+    /**
+     * @brief 从绑定到 buffer_node 的缓冲区池获取预处理输出张量，作为 preprocess 的 out 参数
+     * @param shape 张量形状，字节数不超过 [1, 3, imgsz, imgsz] 的 Float16 张量
+     * @param dtype 数据类型
+     * @return 张量释放时缓冲区自动归还；未配置 buffer_node 或超出缓冲区大小时返回未定义张量
+     */
+    torch::Tensor acquire_output(const std::vector<int64_t>& shape, torch::Dtype dtype) const;
+
+private:
+    /**
+     * @brief 在当前线程预处理已解码的图像
+     */
+    IngestResult to_tensor(DecodedImage decoded) const;
+
+    /**
+     * @brief 获取批量解码线程池，首次调用时创建
+     */
+    ThreadPool& pool();
+
+private:
+    int imgsz_;
+    int thread_nums_;
+    std::vector<int> cpus_;
+    std::unique_ptr<ThreadPool> pool_;
+    std::unique_ptr<NodeBufferPool> buffers_;
+};
+
+#endif // ADAS_MONOREPO_MODULES_PERCEPTION_CAMERA_DETECTION_GESTURE_DETECTOR_YOLOV8S_IMAGE_INGEST_H
@@ -0,0 +1,138 @@
+/**
+ * @file letterbox_plan.h
+ * @brief letterbox 缩放计划，用于 YOLOv8 模型输入
+ * @details 按输入尺寸与 letterbox 参数预先计算缩放比例、填充区域、定点双线性插值抽头
+ *          以及回映射到原图的参数，并按几何参数缓存；输入分辨率不变时每帧只执行插值内核，
+ *          后处理通过 ratio_pad() 使用同一映射将检测框还原到原图。
+ */
+#ifndef ADAS_MONOREPO_MODULES_PERCEPTION_CAMERA_DETECTION_GESTURE_DETECTOR_YOLOV8S_LETTERBOX_PLAN_H
+#define ADAS_MONOREPO_MODULES_PERCEPTION_CAMERA_DETECTION_GESTURE_DETECTOR_YOLOV8S_LETTERBOX_PLAN_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+#include <torch/torch.h>
+
+/**
+ * @brief letterbox 几何参数，作为缓存键
+ */
+struct LetterboxKey {
+    int src_w = 0;
+    int src_h = 0;
+    int dst_w = 640;
+    int dst_h = 640;
+    bool auto_ = false;
+    bool scaleFill = false;
+    bool scaleup = true;
+    int stride = 32;
+
+    bool operator==(const LetterboxKey& other) const {
+        return src_w == other.src_w && src_h == other.src_h && dst_w == other.dst_w &&
+               dst_h == other.dst_h && auto_ == other.auto_ && scaleFill == other.scaleFill &&
+               scaleup == other.scaleup && stride == other.stride;
+    }
+};
+
+struct LetterboxKeyHash {
+    size_t operator()(const LetterboxKey& key) const {
+        size_t h = static_cast<size_t>(key.src_w) * 73856093u ^ static_cast<size_t>(key.src_h) * 19349663u;
+        h ^= static_cast<size_t>(key.dst_w) * 83492791u ^ static_cast<size_t>(key.dst_h) * 2654435761u;
+        h ^= (key.auto_ ? 1u : 0u) | (key.scaleFill ? 2u : 0u) | (key.scaleup ? 4u : 0u);
+        return h ^ static_cast<size_t>(key.stride) << 3;
+    }
+};
+
+/**
+ * @brief letterbox 缩放计划
+ */
+struct LetterboxPlan {
+    static constexpr int kCoefBits = 11;                // 插值系数定点位数（与 OpenCV INTER_LINEAR 一致）
+    static constexpr int kCoefScale = 1 << kCoefBits;
+
+    LetterboxKey key;
+    cv::Point2f ratio;      // 宽、高方向缩放比例
+    cv::Point2f pad;        // 左右、上下方向单侧填充量（letterbox 接口的 pad 输出）
+    cv::Size unpad;         // 缩放后（未填充）尺寸
+    cv::Size out_size;      // 填充后输出尺寸
+    int top = 0;
+    int bottom = 0;
+    int left = 0;
+    int right = 0;
+
+    // 定点双线性抽头：输出第 i 列取源列 x0[i]/x1[i]，x1 的权重为 wx[i]/kCoefScale
+    std::vector<int> x0;
+    std::vector<int> x1;
+    std::vector<int16_t> wx;
+    std::vector<int> y0;
+    std::vector<int> y1;
+    std::vector<int16_t> wy;
+
+    /**
+     * @brief 根据几何参数构建计划
+     * @param key letterbox 几何参数
+     * @return 构建好的计划
+     */
+    static LetterboxPlan build(const LetterboxKey& key);
+
+    /**
+     * @brief 生成 scale_boxes 所需的 ratio_pad 参数 (gain, {pad_w, pad_h})
+     * @details gain 为标量张量：scale_boxes 只使用一个缩放比例（与 ultralytics 取 ratio_pad[0][0] 一致），
+     *          取宽方向比例；pad 为实际绘制的左、上边框宽度。
+     * @param dst_size 检测框还原的目标图像尺寸，为空时取计划的源尺寸；
+     *                 可传入源图像的原始分辨率（如 DCT 缩放解码前的尺寸），缩放比例按宽度之比换算
+     */
+    std::pair<torch::Tensor, std::vector<float>> ratio_pad(const cv::Size& dst_size = cv::Size()) const;
+
+    /**
+     * @brief 填充 [1, 3, H, W] Float16 输出张量中的 letterbox 边框区域
+     * @details 有效区域每帧都会整体重写，复用输出张量时只需填充边框。
+     */
+    void fill_padding(torch::Tensor& out) const;
+};
+
+/**
+ * @brief letterbox 计划缓存，线程安全
+ * @details 超过 kMaxPlans 个几何参数时淘汰最久未使用的计划。
+ */
+class LetterboxPlanCache {
+    public:
+    /**
+     * @brief 获取全局缓存实例
+     */
+    static LetterboxPlanCache& instance();
+
+    /**
+     * @brief 获取（或构建并缓存）计划
+     * @param key letterbox 几何参数
+     * @return 共享的只读计划
+     */
+    std::shared_ptr<const LetterboxPlan> get(const LetterboxKey& key);
+
+    /**
+     * @brief 获取固定 imgsz x imgsz 输入（不按 stride 对齐）的计划
+     * @param src_size 输入图像尺寸
+     * @param imgsz 模型输入尺寸
+     */
+    std::shared_ptr<const LetterboxPlan> get(const cv::Size& src_size, int imgsz);
+
+    void clear();
+
+    static constexpr size_t kMaxPlans = 16;
+
+private:
+
+    using PlanList = std::list<std::shared_ptr<const LetterboxPlan>>;
+
+    std::mutex mutex_;
+    PlanList lru_;      // 头部为最近使用
+    std::unordered_map<LetterboxKey, PlanList::iterator, LetterboxKeyHash> plans_;
+};
+
+#endif // ADAS_MONOREPO_MODULES_PERCEPTION_CAMERA_DETECTION_GESTURE_DETECTOR_YOLOV8S_LETTERBOX_PLAN_H
@@ -23,6 +23,7 @@
 #include <torch/script.h>
 
 #include "common.h"
+#include "letterbox_plan.h"
 
 #include <unistd.h>
 
@@ -38,6 +39,11 @@ namespace fs = std::filesystem;
  */
 class YoloV8sPostprocess {
 public:
+  // 检测阈值，与 postprocess(out_data, cv_image, ...) 的库内实现保持一致，两个重载共用
+  static constexpr float kConfThres = 0.25f;
+  static constexpr float kIouThres = 0.5f;
+  static constexpr int kMaxDet = 300;
+
   /**
   * @brief 构造函数，初始化后处理对象
   */
@@ -87,6 +93,27 @@ public:
   bool postprocess(
     uint8_t* out_data, cv::Mat& cv_image,DetectionResult &det_result, bool draw_save_image = false);
 
+/**
+ * @brief 使用预处理时的 letterbox 计划还原检测框的后处理
+ * @details 解码、NMS、结果填充与绘制流程与 postprocess 相同，但 scale_boxes 使用
+ *          plan.ratio_pad() 给出的缩放比例与填充量，不再按 cv_image 尺寸重新推算 letterbox。
+ *          cv_image 可以是构建计划的图像，也可以是它的原始分辨率版本（如 DCT 缩放解码前的原图），
+ *          检测框始终还原到 cv_image 的坐标系。阈值使用 kConfThres、kIouThres、kMaxDet，
+ *          输出形状与排布取自 describe_model(YOLOV8S)；每个检测打印一行日志，绘制后只保存一张结果图。
+ *
+ * @param[in] out_data        模型推理输出数据
+ * @param[in] plan            预处理使用的 letterbox 计划
+ * @param[in,out] cv_image    还原与绘制的目标图像（BGR 格式）
+ * @param[out] det_result     检测结果
+ * @param[in] draw_save_image 是否在图像上绘制检测结果并保存，默认为 false
+ *
+ * @return true  表示后处理成功
+ * @return false 表示后处理失败
+ */
+  bool postprocess(
+    uint8_t* out_data, const LetterboxPlan& plan, cv::Mat& cv_image, DetectionResult &det_result,
+    bool draw_save_image = false);
+
 private:
 /**
  * @brief 初始化 YOLOv8s 模型
@@ -287,6 +314,14 @@ private:
       float iou_thres,
       int max_det, bool draw_save_image = false
   );
+  int postProcessAnnotate(
+      uint8_t* Reshape_output_0, DetectionResult &det_result,
+      cv::Mat& image,
+      const LetterboxPlan& plan,
+      float conf_thres,
+      float iou_thres,
+      int max_det, bool draw_save_image = false
+  );
   void compare_tensors(const torch::Tensor& a, const torch::Tensor& b);
   template<typename T>
   bool loadBinaryFile(const std::string& filename, std::vector<T>& data);
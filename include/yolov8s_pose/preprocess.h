@@ -13,12 +13,35 @@
 #include <torch/torch.h>
 #include <torch/script.h>
 
+#include "letterbox_plan.h"
+
 // namespace apollo {
 // namespace perception {
 // namespace camera {
 
 using namespace std;
 namespace fs = std::filesystem;
+
+/**
+ * @brief 相机/视频解码器输出的 YUV 像素格式
+ */
+enum class YuvFormat {
+    NV12,   // Y 平面 + UV 交织平面（4:2:0）
+    I420,   // Y、U、V 三个平面（4:2:0）
+    YUYV,   // Y0 U Y1 V 打包格式（4:2:2）
+};
+
+/**
+ * @brief 外部 YUV 帧描述，平面指针直接引用外部内存（零拷贝）
+ */
+struct YuvFrame {
+    YuvFormat format = YuvFormat::NV12;
+    int width = 0;
+    int height = 0;
+    const uint8_t* planes[3] = {nullptr, nullptr, nullptr};  // NV12: Y/UV; I420: Y/U/V; YUYV: 打包数据
+    int strides[3] = {0, 0, 0};                              // 每个平面的行跨度（字节），0 表示紧密排列
+};
+
 class yolov8sPreprocess {
     public:
     /**
@@ -28,6 +51,83 @@ class yolov8sPreprocess {
      * @return torch::Tensor 形状为 [1, 3, H, W] 的 Float32 张量
      */
     torch::Tensor preprocess(const cv::Mat& image, int imgsz);
+
+    /**
+     * @brief 按预先计算的 letterbox 计划对输入图像进行预处理
+     * @details 只执行定点双线性插值、BGR->RGB 与归一化内核，缩放参数与插值系数来自计划。
+     * @param image 输入的 OpenCV 图像（BGR 格式，尺寸需与计划一致）
+     * @param plan letterbox 计划，通常由 LetterboxPlanCache 获取
+     * @param out 可复用的输出张量，形状不匹配或未定义时重新分配
+     * @return torch::Tensor 形状为 [1, 3, H, W] 的 Float16 张量
+     */
+    torch::Tensor preprocess(const cv::Mat& image, const LetterboxPlan& plan, torch::Tensor out = torch::Tensor());
+
+    /**
+     * @brief 按 letterbox 计划生成 uint8 NHWC 输入，不做归一化
+     * @details 用于归一化（/255）已折叠进模型首层的 uint8 输入模型，
+     *          传输字节数为 Float16 输入的一半，且省去主机端归一化计算。
+     * @param image 输入的 OpenCV 图像（BGR 格式，尺寸需与计划一致）
+     * @param plan letterbox 计划
+     * @param out 可复用的输出张量，形状不匹配或未定义时重新分配
+     * @return torch::Tensor 形状为 [1, H, W, 3] 的 UInt8 张量（RGB 顺序）
+     */
+    torch::Tensor preprocess_u8(const cv::Mat& image, const LetterboxPlan& plan, torch::Tensor out = torch::Tensor());
+
+    /**
+     * @brief 对 YUV 帧进行预处理，返回 Torch 张量
+     * @details 颜色转换（BT.601）、letterbox 缩放填充与归一化在一次遍历中完成，
+     *          不生成中间 BGR/RGB 图像。
+     * @param frame 输入的 YUV 帧（NV12、I420 或 YUYV）
+     * @param imgsz 模型输入尺寸（通常为 640）
+     * @return torch::Tensor 形状为 [1, 3, imgsz, imgsz] 的 Float16 张量（RGB 顺序）
+     */
+    torch::Tensor preprocess(const YuvFrame& frame, int imgsz);
+
+    /**
+     * @brief 按预先计算的 letterbox 计划对 YUV 帧进行预处理
+     * @param frame 输入的 YUV 帧（尺寸需与计划一致）
+     * @param plan letterbox 计划
+     * @param out 可复用的输出张量，形状不匹配或未定义时重新分配
+     * @return torch::Tensor 形状为 [1, 3, H, W] 的 Float16 张量（RGB 顺序）
+     */
+    torch::Tensor preprocess(const YuvFrame& frame, const LetterboxPlan& plan, torch::Tensor out = torch::Tensor());
+
+    /**
+     * @brief 对 NV12 帧进行预处理
+     * @param y Y 平面
+     * @param uv UV 交织平面
+     * @param width 图像宽度
+     * @param height 图像高度
+     * @param imgsz 模型输入尺寸
+     * @param y_stride Y 平面行跨度，0 表示等于 width
+     * @param uv_stride UV 平面行跨度，0 表示等于 width
+     */
+    torch::Tensor preprocess_nv12(const uint8_t* y, const uint8_t* uv, int width, int height, int imgsz,
+                                  int y_stride = 0, int uv_stride = 0);
+
+    /**
+     * @brief 对 I420 帧进行预处理
+     * @param y Y 平面
+     * @param u U 平面
+     * @param v V 平面
+     * @param width 图像宽度
+     * @param height 图像高度
+     * @param imgsz 模型输入尺寸
+     * @param y_stride Y 平面行跨度，0 表示等于 width
+     * @param uv_stride U/V 平面行跨度，0 表示等于 (width + 1) / 2
+     */
+    torch::Tensor preprocess_i420(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                                  int width, int height, int imgsz, int y_stride = 0, int uv_stride = 0);
+
+    /**
+     * @brief 对 YUYV 帧进行预处理
+     * @param yuyv 打包数据
+     * @param width 图像宽度
+     * @param height 图像高度
+     * @param imgsz 模型输入尺寸
+     * @param stride 行跨度，0 表示等于 width * 2
+     */
+    torch::Tensor preprocess_yuyv(const uint8_t* yuyv, int width, int height, int imgsz, int stride = 0);
 private:
 
     /**
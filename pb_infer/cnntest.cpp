@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <assert.h>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <exception>
@@ -11,6 +12,7 @@
 #include <iostream>
 #include <filesystem>
 #include <limits>
+#include <memory>
 #include <stdexcept>
 #include <sys/types.h>
 #include <unordered_map>
@@ -23,6 +25,7 @@ using namespace std;
 static struct {
     std::string model_root_path{"/data/models/pbnn"};
     std::string test_results_path{"./cnn_results.json"};
+    std::string preload_config;
 } options;
 
 static std::unordered_map<int, std::string> model_files= {
@@ -40,9 +43,17 @@ struct Similarity {
 
 static int test_case_idx = 0;
 static nlohmann::ordered_json test_results;
+// NPU 原生布局为 NHWC，数据布局与之相同时不做转换
+static const std::string native_layout = "NHWC";
+// 当前用例主机端转置的字节数
+static size_t transposed_bytes = 0;
+
+// 预加载的模型句柄，测试期间保持连接
+static std::vector<std::unique_ptr<ModelHandler>> preloaded_models;
 
 void run_test_file(const std::string &config_filename);
 void run_test_case(const nlohmann::json test_case, const fs::path &config_dir);
+void run_preload(const std::string &config_filename);
 
 // 软件实现的fp16到double转换
 double fp16_to_fp64_soft(uint16_t fp16) {
@@ -266,19 +277,26 @@ bool load_binary_file(const std::string& filename, std::vector<T>& data) {
     return true;
 }
 
-void load_input(const string& file, const string data_type, std::vector<int64_t>& shape, std::vector<uint8_t>& output) {
+void load_input(const string& file, const string data_type, const string& layout, std::vector<int64_t>& shape, std::vector<uint8_t>& output) {
     assert(shape.size() == 4);
 
+    if (layout == native_layout) {
+        // 输入文件已是原生布局，直接发送
+        load_binary_file(file, output);
+        return;
+    }
     if (data_type == "float16") {
         std::vector<uint16_t> nchw_data;
         load_binary_file(file, nchw_data);
         auto nhwc_data = convert_nchw_to_nhwc(nchw_data, shape[0], shape[1], shape[2], shape[3]);
         output.resize(nhwc_data.size() * sizeof(uint16_t));
         memcpy(output.data(), reinterpret_cast<uint8_t*>(nhwc_data.data()), output.size());
+        transposed_bytes += output.size();
     } else if (data_type == "uint8_t") {
         std::vector<uint8_t> nchw_data;
         load_binary_file(file, nchw_data);
         output = convert_nchw_to_nhwc(nchw_data, shape[0], shape[1], shape[2], shape[3]);
+        transposed_bytes += output.size();
     } else {
         std::cerr << "unsuported binary data type: " << data_type << std::endl;
     }
@@ -298,14 +316,19 @@ Similarity verify_fp16_data(std::vector<uint16_t>& data1, std::vector<uint16_t>&
     return result;
 }
 
-Similarity verify_data(const CnnChatData& data, const std::string golden_file, const std::vector<int64_t>& golden_shape) {
+Similarity verify_data(const CnnChatData& data, const std::string golden_file, const std::vector<int64_t>& golden_shape, const std::string& golden_layout) {
     assert(data.data_shape == golden_shape);
     if (data.data_type == "float16") {
         std::vector<uint16_t> golden_data;
         load_binary_file(golden_file, golden_data);
         std::vector<uint16_t> nhwc(data.data.size()/ sizeof(uint16_t));
         memcpy(reinterpret_cast<uint8_t*>(nhwc.data()), data.data.data(), data.data.size());
+        if (golden_layout == native_layout) {
+            // golden 已是原生布局，逐元素比较与布局无关
+            return verify_fp16_data(nhwc, golden_data);
+        }
         auto nchw = convert_nhwc_to_nchw(nhwc, data.data_shape[0], data.data_shape[1], data.data_shape[2], data.data_shape[3]);
+        transposed_bytes += data.data.size();
         return verify_fp16_data(nchw, golden_data);
     } else if (data.data_type == "uint8_t") {
         //TODO:
@@ -319,6 +342,7 @@ int main(int argc, char* argv[]) {
         static struct option long_options[] = {
             {"help", no_argument, 0, 'h'},
             {"model-root-path", required_argument, 0, 0},
+            {"preload", required_argument, 0, 0},
             {0, 0, 0, 0}
         };
         int option_index = 0;
@@ -333,6 +357,7 @@ int main(int argc, char* argv[]) {
             std::cout << R"(Options:
   -h, --help                      Display this information
       --model-root-path=PATH      Model root path
+      --preload=FILE              Warm up models listed in the "preload" section of FILE (e.g. pb_infer.json)
   -o FILE                         Output test results to FILE (default: ./test_results.json)
 )";
             return 0;
@@ -342,6 +367,8 @@ int main(int argc, char* argv[]) {
         case 0:
             if (long_options[option_index].name == std::string("model-root-path")) {
                 options.model_root_path = optarg;
+            } else if (long_options[option_index].name == std::string("preload")) {
+                options.preload_config = optarg;
             } else {
                 std::cerr << "Unknown option: " << long_options[option_index].name << std::endl;
                 return 1;
@@ -357,6 +384,9 @@ int main(int argc, char* argv[]) {
         std::cerr << "Usage: " << argv[0] << " [options] config_file..." << std::endl;
         return 1;
     }
+    if (!options.preload_config.empty()) {
+        run_preload(options.preload_config);
+    }
     for (int i = optind; i < argc; i++) {
         run_test_file(argv[i]);
     }
@@ -402,6 +432,7 @@ void run_test_case(const nlohmann::json test_case, const fs::path& config_dir) {
         model.init(model_id, model_path);
         CnnChatCompletions request;
         request.case_name = name;
+        transposed_bytes = 0;
         for (const auto& input: test_case.at("inputs")) {
             const std::string& input_type = input.at("type");
             CnnChatData part;
@@ -409,7 +440,8 @@ void run_test_case(const nlohmann::json test_case, const fs::path& config_dir) {
                 part.data_type = input.at("data_type");
                 input.at("shape").get_to(part.data_shape);
                 std::string input_path = config_dir/input.at("pixel_file");
-                load_input(input_path, part.data_type, part.data_shape, part.data); 
+                std::string layout = input.value("layout", "NCHW");
+                load_input(input_path, part.data_type, layout, part.data_shape, part.data);
                 request.data_info.push_back(std::move(part));
             } else if (input_type == "image") {
                 //TODO:
@@ -428,7 +460,8 @@ void run_test_case(const nlohmann::json test_case, const fs::path& config_dir) {
             std::string golden_file = config_dir/golden.at("file");
             std::vector<int64_t> golden_shape;
             golden.at("shape").get_to(golden_shape);
-            auto cmp = verify_data(result.data_info[output_id], golden_file, golden_shape);
+            std::string golden_layout = golden.value("layout", "NCHW");
+            auto cmp = verify_data(result.data_info[output_id], golden_file, golden_shape, golden_layout);
             details.push_back({
                 {"output index", output_id},
                 {"mse", cmp.mse},
@@ -441,6 +474,7 @@ void run_test_case(const nlohmann::json test_case, const fs::path& config_dir) {
         test_results["cases"].push_back({
             {"index", test_case_idx},
             {"name", name},
+            {"transposed bytes", transposed_bytes},
             {"result", details}
         });
 
@@ -455,4 +489,76 @@ void run_test_case(const nlohmann::json test_case, const fs::path& config_dir) {
         });
     }
     test_case_idx++;
-}
\ No newline at end of file
+}
+
+void run_preload(const std::string &config_filename) {
+    std::ifstream config_file(config_filename);
+    if (!config_file) {
+        std::cerr << "Failed to open preload config " << config_filename << ": " << strerror(errno) << std::endl;
+        return;
+    }
+    nlohmann::json config;
+    try {
+        config_file >> config;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return;
+    }
+    using clock = std::chrono::steady_clock;
+    for (const auto &entry : config.value("preload", nlohmann::json::array())) {
+        // model_id 缺失或类型错误时只记录该条目失败，-1 表示未能解析
+        int model_id = -1;
+        try {
+            model_id = entry.at("model_id");
+            std::string model_path = options.model_root_path + "/" + model_files[model_id];
+            auto start = clock::now();
+            auto model = std::make_unique<ModelHandler>();
+            int ret = model->init(model_id, model_path);
+            auto init_done = clock::now();
+            if (ret != PBNN_SUCCESS) {
+                throw std::runtime_error("init failed with " + std::to_string(ret));
+            }
+
+            // 用全零输入执行一次推理，完成后才视为就绪
+            const auto &warmup_inputs = entry.value("warmup_inputs", nlohmann::json::array());
+            if (!warmup_inputs.empty()) {
+                CnnChatCompletions request;
+                request.case_name = "warmup";
+                for (const auto &input : warmup_inputs) {
+                    CnnChatData part;
+                    part.data_type = input.at("data_type");
+                    input.at("shape").get_to(part.data_shape);
+                    size_t count = 1;
+                    for (auto dim : part.data_shape) {
+                        count *= static_cast<size_t>(dim);
+                    }
+                    part.data.assign(count * (part.data_type == "float16" ? sizeof(uint16_t) : sizeof(uint8_t)), 0);
+                    request.data_info.push_back(std::move(part));
+                }
+                model->input(request);
+                ret = model->execute();
+                if (ret != PBNN_SUCCESS) {
+                    throw std::runtime_error("warm-up execute failed with " + std::to_string(ret));
+                }
+                model->output();
+            }
+            auto ready = clock::now();
+
+            double init_ms = std::chrono::duration<double, std::milli>(init_done - start).count();
+            double ready_ms = std::chrono::duration<double, std::milli>(ready - start).count();
+            std::cout << "Model " << model_id << " ready in " << ready_ms << " ms (init " << init_ms << " ms)" << std::endl;
+            test_results["preload"].push_back({
+                {"model_id", model_id},
+                {"init ms", init_ms},
+                {"time to ready ms", ready_ms}
+            });
+            preloaded_models.push_back(std::move(model));
+        } catch (const std::exception &e) {
+            std::cerr << "Error: preload model " << model_id << ": " << e.what() << std::endl;
+            test_results["preload"].push_back({
+                {"model_id", model_id},
+                {"error", e.what()}
+            });
+        }
+    }
+}
@@ -0,0 +1,416 @@
+#include "pb_sdk/audio_features.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#ifdef PB_HAVE_SAMPLERATE
+#include <samplerate.h>
+#endif
+#ifdef PB_HAVE_SNDFILE
+#include <sndfile.h>
+#endif
+
+#include "pb_sdk/fp16.h"
+
+namespace {
+
+double hz_to_mel(double hz) {
+    // Slaney 梅尔刻度：1kHz 以下线性，以上对数
+    const double f_sp = 200.0 / 3.0;
+    const double min_log_hz = 1000.0;
+    const double min_log_mel = min_log_hz / f_sp;
+    const double logstep = std::log(6.4) / 27.0;
+    return hz >= min_log_hz ? min_log_mel + std::log(hz / min_log_hz) / logstep : hz / f_sp;
+}
+
+double mel_to_hz(double mel) {
+    const double f_sp = 200.0 / 3.0;
+    const double min_log_hz = 1000.0;
+    const double min_log_mel = min_log_hz / f_sp;
+    const double logstep = std::log(6.4) / 27.0;
+    return mel >= min_log_mel ? min_log_hz * std::exp(logstep * (mel - min_log_mel)) : mel * f_sp;
+}
+
+#ifdef PB_HAVE_SNDFILE
+/**
+ * @brief libsndfile 内存读取回调
+ */
+struct MemoryStream {
+    const uint8_t* data;
+    sf_count_t len;
+    sf_count_t pos;
+};
+
+sf_count_t mem_get_filelen(void* user) {
+    return static_cast<MemoryStream*>(user)->len;
+}
+
+sf_count_t mem_seek(sf_count_t offset, int whence, void* user) {
+    auto* stream = static_cast<MemoryStream*>(user);
+    sf_count_t pos = whence == SEEK_SET ? offset : (whence == SEEK_CUR ? stream->pos + offset : stream->len + offset);
+    stream->pos = std::clamp<sf_count_t>(pos, 0, stream->len);
+    return stream->pos;
+}
+
+sf_count_t mem_read(void* ptr, sf_count_t count, void* user) {
+    auto* stream = static_cast<MemoryStream*>(user);
+    sf_count_t n = std::min(count, stream->len - stream->pos);
+    std::memcpy(ptr, stream->data + stream->pos, static_cast<size_t>(n));
+    stream->pos += n;
+    return n;
+}
+
+sf_count_t mem_write(const void*, sf_count_t, void*) {
+    return 0;
+}
+
+sf_count_t mem_tell(void* user) {
+    return static_cast<MemoryStream*>(user)->pos;
+}
+#endif  // PB_HAVE_SNDFILE
+
+}  // namespace
+
+StreamingAudioFeatures::StreamingAudioFeatures(const AudioFeatureConfig& config)
+    : m_config(config), m_resampler(nullptr)
+{
+    const int n_fft = m_config.n_fft;
+    const int n_bins = n_fft / 2 + 1;
+    const double pi = std::acos(-1.0);
+
+    m_window.resize(n_fft);
+    for (int n = 0; n < n_fft; ++n) {
+        m_window[n] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * pi * n / n_fft));
+    }
+
+    // n_fft 不一定是 2 的幂（默认 400），用预计算的 DFT 表做实数变换，内层循环连续访存便于向量化
+    m_dft_cos.resize(static_cast<size_t>(n_bins) * n_fft);
+    m_dft_sin.resize(static_cast<size_t>(n_bins) * n_fft);
+    for (int k = 0; k < n_bins; ++k) {
+        for (int n = 0; n < n_fft; ++n) {
+            double angle = 2.0 * pi * static_cast<double>((static_cast<int64_t>(k) * n) % n_fft) / n_fft;
+            m_dft_cos[static_cast<size_t>(k) * n_fft + n] = static_cast<float>(std::cos(angle));
+            m_dft_sin[static_cast<size_t>(k) * n_fft + n] = static_cast<float>(-std::sin(angle));
+        }
+    }
+
+    // Slaney 归一化的三角梅尔滤波器，只保存非零区间
+    const int n_mels = m_config.n_mels;
+    const double max_mel = hz_to_mel(m_config.sample_rate / 2.0);
+    std::vector<double> f_pts(n_mels + 2);
+    for (int i = 0; i < n_mels + 2; ++i) {
+        f_pts[i] = mel_to_hz(max_mel * i / (n_mels + 1));
+    }
+    m_mel_begin.resize(n_mels);
+    m_mel_end.resize(n_mels);
+    m_mel_offset.resize(n_mels);
+    for (int m = 0; m < n_mels; ++m) {
+        const double enorm = 2.0 / (f_pts[m + 2] - f_pts[m]);
+        m_mel_begin[m] = n_bins;
+        m_mel_end[m] = 0;
+        m_mel_offset[m] = m_mel_weights.size();
+        std::vector<float> weights;
+        for (int k = 0; k < n_bins; ++k) {
+            double freq = static_cast<double>(k) * m_config.sample_rate / n_fft;
+            double lower = (freq - f_pts[m]) / (f_pts[m + 1] - f_pts[m]);
+            double upper = (f_pts[m + 2] - freq) / (f_pts[m + 2] - f_pts[m + 1]);
+            double weight = std::max(0.0, std::min(lower, upper)) * enorm;
+            if (weight > 0.0) {
+                m_mel_begin[m] = std::min(m_mel_begin[m], k);
+                m_mel_end[m] = k + 1;
+            }
+            weights.push_back(static_cast<float>(weight));
+        }
+        if (m_mel_end[m] > m_mel_begin[m]) {
+            m_mel_weights.insert(m_mel_weights.end(), weights.begin() + m_mel_begin[m], weights.begin() + m_mel_end[m]);
+        } else {
+            m_mel_begin[m] = 0;
+        }
+    }
+
+    m_frame.resize(n_fft);
+    m_power.resize(n_bins);
+    reset();
+}
+
+StreamingAudioFeatures::~StreamingAudioFeatures()
+{
+#ifdef PB_HAVE_SAMPLERATE
+    if (m_resampler != nullptr) {
+        src_delete(m_resampler);
+    }
+#endif
+}
+
+void StreamingAudioFeatures::reset()
+{
+#ifdef PB_HAVE_SAMPLERATE
+    if (m_resampler != nullptr) {
+        src_delete(m_resampler);
+    }
+#endif
+    m_resampler = nullptr;
+    m_input_rate = 0;
+    m_samples.clear();
+    m_samples_begin = 0;
+    m_total_samples = 0;
+    m_next_frame = 0;
+    m_finished = false;
+    m_log_mel.clear();
+}
+
+int StreamingAudioFeatures::push_pcm(const float* samples, size_t frames, int channels, int sample_rate)
+{
+    if (m_finished || samples == nullptr || channels <= 0 || sample_rate <= 0) {
+        return -1;
+    }
+    std::vector<float> mono(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        float sum = 0.0f;
+        for (int c = 0; c < channels; ++c) {
+            sum += samples[i * channels + c];
+        }
+        mono[i] = sum / channels;
+    }
+
+    if (sample_rate == m_config.sample_rate) {
+        append_mono(mono.data(), mono.size());
+        return compute_ready_frames(false);
+    }
+
+#ifndef PB_HAVE_SAMPLERATE
+    std::cerr << "Error: built without libsamplerate, cannot resample " << sample_rate << " Hz to "
+              << m_config.sample_rate << " Hz" << std::endl;
+    return -1;
+#else
+    if (m_resampler == nullptr || m_input_rate != sample_rate) {
+        if (m_resampler != nullptr) {
+            src_delete(m_resampler);
+        }
+        int error = 0;
+        m_resampler = src_new(SRC_SINC_FASTEST, 1, &error);
+        if (m_resampler == nullptr) {
+            std::cerr << "Error: src_new failed: " << src_strerror(error) << std::endl;
+            return -1;
+        }
+        m_input_rate = sample_rate;
+    }
+
+    const double ratio = static_cast<double>(m_config.sample_rate) / sample_rate;
+    std::vector<float> out(static_cast<size_t>(frames * ratio) + 64);
+    SRC_DATA data;
+    std::memset(&data, 0, sizeof(data));
+    data.data_in = mono.data();
+    data.input_frames = static_cast<long>(frames);
+    data.src_ratio = ratio;
+    data.end_of_input = 0;
+    while (data.input_frames > 0) {
+        data.data_out = out.data();
+        data.output_frames = static_cast<long>(out.size());
+        int error = src_process(m_resampler, &data);
+        if (error != 0) {
+            std::cerr << "Error: src_process failed: " << src_strerror(error) << std::endl;
+            return -1;
+        }
+        append_mono(out.data(), static_cast<size_t>(data.output_frames_gen));
+        data.data_in += data.input_frames_used;
+        data.input_frames -= data.input_frames_used;
+        if (data.input_frames_used == 0 && data.output_frames_gen == 0) {
+            break;
+        }
+    }
+    return compute_ready_frames(false);
+#endif  // PB_HAVE_SAMPLERATE
+}
+
+bool StreamingAudioFeatures::push_file(const std::string& path, size_t chunk_frames)
+{
+#ifndef PB_HAVE_SNDFILE
+    (void)chunk_frames;
+    std::cerr << "Error: built without libsndfile, cannot decode audio " << path << std::endl;
+    return false;
+#else
+    SF_INFO info;
+    std::memset(&info, 0, sizeof(info));
+    SNDFILE* file = sf_open(path.c_str(), SFM_READ, &info);
+    if (file == nullptr) {
+        std::cerr << "Error: Cannot open audio " << path << ": " << sf_strerror(nullptr) << std::endl;
+        return false;
+    }
+    std::vector<float> buffer(chunk_frames * info.channels);
+    sf_count_t n;
+    while ((n = sf_readf_float(file, buffer.data(), static_cast<sf_count_t>(chunk_frames))) > 0) {
+        if (push_pcm(buffer.data(), static_cast<size_t>(n), info.channels, info.samplerate) < 0) {
+            sf_close(file);
+            return false;
+        }
+    }
+    sf_close(file);
+    return true;
+#endif  // PB_HAVE_SNDFILE
+}
+
+bool StreamingAudioFeatures::push_encoded(const uint8_t* data, size_t len, size_t chunk_frames)
+{
+#ifndef PB_HAVE_SNDFILE
+    (void)data;
+    (void)chunk_frames;
+    std::cerr << "Error: built without libsndfile, cannot decode audio (" << len << " bytes)" << std::endl;
+    return false;
+#else
+    MemoryStream stream{data, static_cast<sf_count_t>(len), 0};
+    SF_VIRTUAL_IO vio{mem_get_filelen, mem_seek, mem_read, mem_write, mem_tell};
+    SF_INFO info;
+    std::memset(&info, 0, sizeof(info));
+    SNDFILE* file = sf_open_virtual(&vio, SFM_READ, &info, &stream);
+    if (file == nullptr) {
+        std::cerr << "Error: Cannot decode audio (" << len << " bytes): " << sf_strerror(nullptr) << std::endl;
+        return false;
+    }
+    std::vector<float> buffer(chunk_frames * info.channels);
+    sf_count_t n;
+    while ((n = sf_readf_float(file, buffer.data(), static_cast<sf_count_t>(chunk_frames))) > 0) {
+        if (push_pcm(buffer.data(), static_cast<size_t>(n), info.channels, info.samplerate) < 0) {
+            sf_close(file);
+            return false;
+        }
+    }
+    sf_close(file);
+    return true;
+#endif  // PB_HAVE_SNDFILE
+}
+
+int StreamingAudioFeatures::finish()
+{
+    if (m_finished) {
+        return 0;
+    }
+#ifdef PB_HAVE_SAMPLERATE
+    if (m_resampler != nullptr) {
+        // 冲刷重采样器内部缓存的尾部采样
+        std::vector<float> out(4096);
+        SRC_DATA data;
+        std::memset(&data, 0, sizeof(data));
+        data.src_ratio = static_cast<double>(m_config.sample_rate) / m_input_rate;
+        data.end_of_input = 1;
+        do {
+            data.data_out = out.data();
+            data.output_frames = static_cast<long>(out.size());
+            if (src_process(m_resampler, &data) != 0) {
+                break;
+            }
+            append_mono(out.data(), static_cast<size_t>(data.output_frames_gen));
+        } while (data.output_frames_gen > 0);
+    }
+#endif
+    m_finished = true;
+    return compute_ready_frames(true);
+}
+
+void StreamingAudioFeatures::append_mono(const float* samples, size_t frames)
+{
+    m_samples.insert(m_samples.end(), samples, samples + frames);
+    m_total_samples += static_cast<int64_t>(frames);
+}
+
+float StreamingAudioFeatures::sample_at(int64_t index) const
+{
+    // center=True 的反射填充
+    const int64_t last = m_total_samples - 1;
+    if (index < 0) {
+        index = -index;
+    }
+    if (index > last) {
+        index = 2 * last - index;
+    }
+    index = std::clamp<int64_t>(index, m_samples_begin, last);
+    return m_samples[static_cast<size_t>(index - m_samples_begin)];
+}
+
+void StreamingAudioFeatures::compute_frame(int64_t center)
+{
+    const int n_fft = m_config.n_fft;
+    const int n_bins = n_fft / 2 + 1;
+    const int64_t start = center - n_fft / 2;
+    for (int n = 0; n < n_fft; ++n) {
+        m_frame[n] = sample_at(start + n) * m_window[n];
+    }
+
+    for (int k = 0; k < n_bins; ++k) {
+        const float* c = m_dft_cos.data() + static_cast<size_t>(k) * n_fft;
+        const float* s = m_dft_sin.data() + static_cast<size_t>(k) * n_fft;
+        float re = 0.0f;
+        float im = 0.0f;
+        for (int n = 0; n < n_fft; ++n) {
+            re += m_frame[n] * c[n];
+            im += m_frame[n] * s[n];
+        }
+        m_power[k] = re * re + im * im;
+    }
+
+    for (int m = 0; m < m_config.n_mels; ++m) {
+        const float* w = m_mel_weights.data() + m_mel_offset[m];
+        float energy = 0.0f;
+        for (int k = m_mel_begin[m]; k < m_mel_end[m]; ++k) {
+            energy += w[k - m_mel_begin[m]] * m_power[k];
+        }
+        m_log_mel.push_back(std::log10(std::max(energy, 1e-10f)));
+    }
+}
+
+int StreamingAudioFeatures::compute_ready_frames(bool final)
+{
+    if (m_total_samples == 0) {
+        return 0;
+    }
+    const int hop = m_config.hop_length;
+    const int half = m_config.n_fft / 2;
+    // 与 Whisper 一致：STFT 帧数为 1 + N / hop，丢弃最后一帧
+    const int64_t total_frames = m_total_samples / hop;
+    int count = 0;
+    while (m_next_frame < total_frames) {
+        const int64_t center = m_next_frame * hop;
+        if (!final && center + half > m_total_samples) {
+            break;
+        }
+        compute_frame(center);
+        m_next_frame++;
+        count++;
+    }
+
+    // 丢弃后续帧不再需要的头部采样
+    const int64_t keep_from = m_next_frame * hop - half;
+    if (keep_from - m_samples_begin > 16 * hop) {
+        m_samples.erase(m_samples.begin(), m_samples.begin() + (keep_from - m_samples_begin));
+        m_samples_begin = keep_from;
+    }
+    return count;
+}
+
+std::vector<uint16_t> StreamingAudioFeatures::packed_fp16() const
+{
+    const int n_mels = m_config.n_mels;
+    const size_t frames = num_frames();
+    std::vector<uint16_t> packed(static_cast<size_t>(n_mels) * frames);
+    if (frames == 0) {
+        return packed;
+    }
+    const float max_value = *std::max_element(m_log_mel.begin(), m_log_mel.end());
+    for (size_t t = 0; t < frames; ++t) {
+        for (int m = 0; m < n_mels; ++m) {
+            float value = std::max(m_log_mel[t * n_mels + m], max_value - 8.0f);
+            packed[static_cast<size_t>(m) * frames + t] = float_to_fp16((value + 4.0f) / 4.0f);
+        }
+    }
+    return packed;
+}
+
+ContentPart StreamingAudioFeatures::to_content_part() const
+{
+    ContentPart part;
+    part.type = "input_audio";
+    part.pixel_data = packed_fp16();
+    return part;
+}
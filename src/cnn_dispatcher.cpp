@@ -0,0 +1,227 @@
+#include "pb_sdk/cnn_dispatcher.h"
+
+#include <exception>
+#include <iostream>
+#include <variant>
+
+CnnDispatcher::CnnDispatcher()
+    : m_next_id(1), m_started(false), m_stop(false)
+{
+}
+
+CnnDispatcher::~CnnDispatcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cond.notify_all();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+
+    // 调度线程退出后仍未下发的请求全部取消，保证每个回调都被调用一次
+    std::deque<Pending> remaining;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        remaining.swap(m_queue);
+        m_stats.cancelled += remaining.size();
+    }
+    for (auto& item : remaining) {
+        CnnRequestResult result;
+        result.id = item.id;
+        result.status = PBNN_CANCELLED;
+        finish(item, result);
+    }
+}
+
+int CnnDispatcher::init(int model, const std::string& model_path)
+{
+    {
+        // 调度线程可能正在使用当前模型，不支持重复初始化
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_started) {
+            return PBNN_INVALID_ARGUMENT;
+        }
+    }
+    auto handler = std::make_unique<ModelHandler>();
+    int ret = handler->init(model, model_path);
+    if (ret != PBNN_SUCCESS) {
+        return ret;
+    }
+    m_model = std::move(handler);
+    ModelHandler* handle = m_model.get();
+    return init([handle](const CnnChatCompletions& request, CnnChatCompletions& response) {
+        handle->input(request);
+        int status = handle->execute();
+        if (status == PBNN_SUCCESS) {
+            response = std::get<CnnChatCompletions>(handle->output());
+        } else if (status > PBNN_INVALID_ARGUMENT) {
+            // 库可能返回 ErrCode（如 FAILED），统一为 PBNN 错误码
+            status = PBNN_EXECUTE_FAILED;
+        }
+        return status;
+    });
+}
+
+int CnnDispatcher::init(cnn_executor_t executor)
+{
+    if (!executor) {
+        return PBNN_INVALID_ARGUMENT;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_started) {
+            return PBNN_INVALID_ARGUMENT;
+        }
+        m_executor = std::move(executor);
+    }
+    if (!m_worker.joinable()) {
+        m_worker = std::thread([this] { worker_loop(); });
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_started = true;
+    }
+    return PBNN_SUCCESS;
+}
+
+uint64_t CnnDispatcher::submit(CnnChatCompletions request, std::chrono::milliseconds timeout, cnn_result_cb_t callback)
+{
+    Pending pending;
+    pending.id = m_next_id++;
+    pending.request = std::move(request);
+    pending.submit_time = clock::now();
+    pending.deadline = pending.submit_time + timeout;
+    pending.callback = std::move(callback);
+    uint64_t id = pending.id;
+    bool rejected = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.submitted++;
+        if (!m_started || m_stop) {
+            // 未初始化、初始化失败或正在析构：没有调度线程处理，直接回调失败
+            rejected = true;
+            m_stats.failed++;
+        } else {
+            m_queue.push_back(std::move(pending));
+        }
+    }
+    if (rejected) {
+        std::cerr << "Error: request " << id << " submitted before a successful init" << std::endl;
+        CnnRequestResult result;
+        result.id = id;
+        result.status = PBNN_INIT_FAILED;
+        finish(pending, result);
+        return id;
+    }
+    m_cond.notify_one();
+    return id;
+}
+
+bool CnnDispatcher::cancel(uint64_t id)
+{
+    Pending cancelled;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto inflight = m_inflight.find(id);
+        if (inflight != m_inflight.end()) {
+            // 已下发，执行完成后丢弃结果
+            inflight->second->store(true);
+            return true;
+        }
+        auto it = m_queue.begin();
+        for (; it != m_queue.end(); ++it) {
+            if (it->id == id) {
+                break;
+            }
+        }
+        if (it == m_queue.end()) {
+            return false;
+        }
+        cancelled = std::move(*it);
+        m_queue.erase(it);
+        m_stats.cancelled++;
+    }
+    CnnRequestResult result;
+    result.id = id;
+    result.status = PBNN_CANCELLED;
+    finish(cancelled, result);
+    return true;
+}
+
+GoodputStats CnnDispatcher::stats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void CnnDispatcher::finish(const Pending& pending, CnnRequestResult& result)
+{
+    result.latency_ms = std::chrono::duration<double, std::milli>(clock::now() - pending.submit_time).count();
+    if (pending.callback) {
+        pending.callback(result);
+    }
+}
+
+void CnnDispatcher::worker_loop()
+{
+    while (true) {
+        Pending pending;
+        std::shared_ptr<std::atomic<bool>> token;
+        cnn_executor_t executor;
+        bool expired = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_stop) {
+                // 未下发的请求由析构函数统一取消
+                return;
+            }
+            pending = std::move(m_queue.front());
+            m_queue.pop_front();
+            if (clock::now() >= pending.deadline) {
+                expired = true;
+                m_stats.expired++;
+            } else {
+                token = std::make_shared<std::atomic<bool>>(false);
+                m_inflight[pending.id] = token;
+                executor = m_executor;
+            }
+        }
+
+        CnnRequestResult result;
+        result.id = pending.id;
+        if (expired) {
+            result.status = PBNN_DEADLINE_EXCEEDED;
+            finish(pending, result);
+            continue;
+        }
+
+        try {
+            result.status = executor(pending.request, result.response);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: request " << pending.id << ": " << e.what() << std::endl;
+            result.status = PBNN_EXECUTE_FAILED;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_inflight.erase(pending.id);
+            if (token->load()) {
+                result.status = PBNN_CANCELLED;
+                result.response = CnnChatCompletions();
+                m_stats.cancelled++;
+            } else if (result.status != PBNN_SUCCESS) {
+                result.response = CnnChatCompletions();
+                m_stats.failed++;
+            } else if (clock::now() > pending.deadline) {
+                result.status = PBNN_DEADLINE_EXCEEDED;
+                m_stats.completed_late++;
+            } else {
+                m_stats.completed_in_deadline++;
+            }
+        }
+        finish(pending, result);
+    }
+}
@@ -0,0 +1,211 @@
+#include "pb_sdk/cpu_affinity.h"
+
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/sysinfo.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+#include "nlohmann/json.hpp"
+
+namespace {
+
+size_t page_size() {
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+}  // namespace
+
+std::vector<int> parse_cpu_list(const std::string& cpu_list) {
+    std::vector<int> cpus;
+    std::stringstream ss(cpu_list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.empty()) {
+            continue;
+        }
+        try {
+            size_t dash = item.find('-');
+            if (dash == std::string::npos) {
+                cpus.push_back(std::stoi(item));
+            } else {
+                int first = std::stoi(item.substr(0, dash));
+                int last = std::stoi(item.substr(dash + 1));
+                if (first > last) {
+                    throw std::invalid_argument(item);
+                }
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+        } catch (const std::exception&) {
+            throw std::invalid_argument("invalid cpu list: " + cpu_list);
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+AffinityConfig load_affinity_config(const std::string& config_path) {
+    AffinityConfig config;
+    std::ifstream file(config_path);
+    if (!file) {
+        return config;
+    }
+    try {
+        nlohmann::json json;
+        file >> json;
+        const auto& affinity = json.value("affinity", nlohmann::json::object());
+        config.decode_cpus = parse_cpu_list(affinity.value("decode", ""));
+        config.preprocess_cpus = parse_cpu_list(affinity.value("preprocess", ""));
+        config.postprocess_cpus = parse_cpu_list(affinity.value("postprocess", ""));
+        config.buffer_node = affinity.value("buffer_node", -1);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: invalid affinity config " << config_path << ": " << e.what() << std::endl;
+    }
+    return config;
+}
+
+bool pin_current_thread(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return true;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            std::cerr << "Error: cpu " << cpu << " is out of range [0, " << CPU_SETSIZE << ")" << std::endl;
+            return false;
+        }
+        CPU_SET(cpu, &set);
+    }
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (ret != 0) {
+        std::cerr << "Error: pthread_setaffinity_np failed: " << ret << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool verify_cpu_isolation(const std::string& role, const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return true;
+    }
+    bool ok = true;
+    const int cpu_count = get_nprocs_conf();
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= cpu_count) {
+            std::cerr << "Warning: " << role << " cpu " << cpu << " does not exist" << std::endl;
+            ok = false;
+        }
+    }
+
+    std::vector<int> isolated;
+    std::ifstream file("/sys/devices/system/cpu/isolated");
+    std::string line;
+    if (file && std::getline(file, line)) {
+        isolated = parse_cpu_list(line);
+    }
+    for (int cpu : cpus) {
+        if (!std::binary_search(isolated.begin(), isolated.end(), cpu)) {
+            std::cerr << "Warning: " << role << " cpu " << cpu << " is not isolated (isolcpus)" << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool bind_to_node(void* addr, size_t size, int node) {
+    if (addr == nullptr || size == 0 || node < 0) {
+        return true;
+    }
+    // mbind 要求起始地址页对齐，只绑定完全属于该内存的整页，避免影响相邻的堆数据
+    const uintptr_t page = page_size();
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(addr) + page - 1) & ~(page - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(addr) + size) & ~(page - 1);
+    if (begin >= end) {
+        std::cerr << "Error: bind_to_node needs at least one whole page, got " << size << " bytes" << std::endl;
+        return false;
+    }
+    constexpr size_t kBitsPerLong = sizeof(unsigned long) * CHAR_BIT;
+    std::vector<unsigned long> nodemask(static_cast<size_t>(node) / kBitsPerLong + 1, 0);
+    nodemask[node / kBitsPerLong] = 1UL << (node % kBitsPerLong);
+    // maxnode 为位数 + 1（内核会先减 1）
+    const unsigned long maxnode = nodemask.size() * kBitsPerLong + 1;
+    long ret = syscall(SYS_mbind, reinterpret_cast<void*>(begin), end - begin, MPOL_BIND, nodemask.data(), maxnode,
+                       MPOL_MF_MOVE);
+    if (ret != 0) {
+        std::cerr << "Error: mbind to node " << node << " failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+struct NodeBufferPool::State {
+    size_t block_size = 0;
+    int node = -1;
+    std::mutex mutex;
+    std::vector<void*> free_blocks;
+
+    ~State() {
+        for (void* block : free_blocks) {
+            munmap(block, block_size);
+        }
+    }
+};
+
+NodeBufferPool::NodeBufferPool(size_t block_size, int node) : m_state(std::make_shared<State>()) {
+    const size_t page = page_size();
+    m_state->block_size = std::max<size_t>(1, (block_size + page - 1) / page) * page;
+    m_state->node = node;
+}
+
+std::shared_ptr<void> NodeBufferPool::acquire() {
+    void* block = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        if (!m_state->free_blocks.empty()) {
+            block = m_state->free_blocks.back();
+            m_state->free_blocks.pop_back();
+        }
+    }
+    if (block == nullptr) {
+        block = mmap(nullptr, m_state->block_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (block == MAP_FAILED) {
+            std::cerr << "Error: mmap " << m_state->block_size << " bytes failed: " << std::strerror(errno) << std::endl;
+            return nullptr;
+        }
+        // 新映射尚未缺页，绑定后首次写入即在目标节点分配物理页
+        bind_to_node(block, m_state->block_size, m_state->node);
+    }
+    // 缓冲区持有池状态，池对象先销毁时缓冲区仍有效，归还后随状态一起释放
+    std::shared_ptr<State> state = m_state;
+    return std::shared_ptr<void>(block, [state](void* ptr) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->free_blocks.push_back(ptr);
+    });
+}
+
+size_t NodeBufferPool::block_size() const {
+    return m_state->block_size;
+}
+
+int NodeBufferPool::node() const {
+    return m_state->node;
+}
@@ -0,0 +1,205 @@
+#include "yolov8s_pose/image_ingest.h"
+
+#include <fstream>
+#include <future>
+#include <iostream>
+
+
+namespace {
+
+int reduced_flag(int scale_denom) {
+    switch (scale_denom) {
+    case 2:
+        return cv::IMREAD_REDUCED_COLOR_2;
+    case 4:
+        return cv::IMREAD_REDUCED_COLOR_4;
+    case 8:
+        return cv::IMREAD_REDUCED_COLOR_8;
+    default:
+        return cv::IMREAD_COLOR;
+    }
+}
+
+bool is_sof_marker(uint8_t marker) {
+    // SOF0~SOF15，排除 DHT(C4)、JPG(C8)、DAC(CC)
+    return marker >= 0xC0 && marker <= 0xCF &&
+           marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+}
+
+}  // namespace
+
+ImageIngest::ImageIngest(int imgsz, int thread_nums, const std::vector<int>& cpus, int buffer_node)
+    : imgsz_(imgsz), thread_nums_(thread_nums), cpus_(cpus) {
+    if (buffer_node >= 0) {
+        buffers_ = std::make_unique<NodeBufferPool>(static_cast<size_t>(3) * imgsz * imgsz * sizeof(at::Half),
+                                                    buffer_node);
+    }
+}
+
+torch::Tensor ImageIngest::acquire_output(const std::vector<int64_t>& shape, torch::Dtype dtype) const {
+    if (!buffers_) {
+        return torch::Tensor();
+    }
+    int64_t numel = 1;
+    for (int64_t dim : shape) {
+        numel *= dim;
+    }
+    if (numel <= 0 || static_cast<size_t>(numel) * c10::elementSize(dtype) > buffers_->block_size()) {
+        return torch::Tensor();
+    }
+    std::shared_ptr<void> buffer = buffers_->acquire();
+    if (!buffer) {
+        return torch::Tensor();
+    }
+    // 张量的 deleter 持有缓冲区引用，张量释放时缓冲区回到池中
+    return torch::from_blob(buffer.get(), shape, [buffer](void*) {}, torch::dtype(dtype));
+}
+
+ThreadPool& ImageIngest::pool() {
+    if (!pool_) {
+        std::vector<int> cpus = cpus_;
+        pool_ = std::make_unique<ThreadPool>(thread_nums_, [cpus](int) { pin_current_thread(cpus); });
+    }
+    return *pool_;
+}
+
+bool ImageIngest::probe_jpeg_size(const uint8_t* data, size_t len, cv::Size& size) {
+    if (data == nullptr || len < 4 || data[0] != 0xFF || data[1] != 0xD8) {
+        return false;
+    }
+    size_t pos = 2;
+    while (pos + 3 < len) {
+        if (data[pos] != 0xFF) {
+            return false;
+        }
+        uint8_t marker = data[pos + 1];
+        if (marker == 0xFF) {
+            // 填充字节
+            pos++;
+            continue;
+        }
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD9)) {
+            // 无长度字段的独立标记
+            pos += 2;
+            continue;
+        }
+        size_t seg_len = (static_cast<size_t>(data[pos + 2]) << 8) | data[pos + 3];
+        if (seg_len < 2) {
+            return false;
+        }
+        if (is_sof_marker(marker)) {
+            if (pos + 8 >= len) {
+                return false;
+            }
+            int height = (data[pos + 5] << 8) | data[pos + 6];
+            int width = (data[pos + 7] << 8) | data[pos + 8];
+            if (width <= 0 || height <= 0) {
+                return false;
+            }
+            size = cv::Size(width, height);
+            return true;
+        }
+        if (marker == 0xDA) {
+            // 扫描数据开始前仍未遇到 SOF
+            return false;
+        }
+        pos += 2 + seg_len;
+    }
+    return false;
+}
+
+int ImageIngest::select_scale(const cv::Size& src_size, int imgsz) {
+    int long_side = std::max(src_size.width, src_size.height);
+    for (int denom : {8, 4, 2}) {
+        // libjpeg 缩放输出尺寸为 ceil(size / denom)
+        if ((long_side + denom - 1) / denom >= imgsz) {
+            return denom;
+        }
+    }
+    return 1;
+}
+
+DecodedImage ImageIngest::decode(const std::string& image_path) const {
+    std::ifstream file(image_path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        std::cerr << "Error: Cannot open image " << image_path << std::endl;
+        return DecodedImage();
+    }
+    const std::streamoff size = file.tellg();
+    if (size <= 0) {
+        std::cerr << "Error: Cannot get size of image " << image_path << std::endl;
+        return DecodedImage();
+    }
+    std::vector<uint8_t> buffer(static_cast<size_t>(size));
+    file.seekg(0, std::ios::beg);
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()))) {
+        std::cerr << "Error: Cannot read image " << image_path << std::endl;
+        return DecodedImage();
+    }
+    return decode(buffer);
+}
+
+DecodedImage ImageIngest::decode(const std::vector<uint8_t>& buffer) const {
+    return decode(buffer.data(), buffer.size());
+}
+
+DecodedImage ImageIngest::decode(const uint8_t* data, size_t len) const {
+    DecodedImage result;
+    if (data == nullptr || len == 0) {
+        return result;
+    }
+    // 仅 JPEG 支持 DCT 域缩放，其他格式按原尺寸解码，避免解码后再缩放
+    if (probe_jpeg_size(data, len, result.src_size)) {
+        result.scale_denom = select_scale(result.src_size, imgsz_);
+    }
+    cv::Mat raw(1, static_cast<int>(len), CV_8UC1, const_cast<uint8_t*>(data));
+    result.image = cv::imdecode(raw, reduced_flag(result.scale_denom));
+    if (result.image.empty()) {
+        std::cerr << "Error: Failed to decode image (" << len << " bytes)" << std::endl;
+        return result;
+    }
+    if (result.src_size.empty()) {
+        result.src_size = result.image.size();
+    }
+    return result;
+}
+
+IngestResult ImageIngest::to_tensor(DecodedImage decoded) const {
+    IngestResult result;
+    result.decoded = std::move(decoded);
+    if (!result.decoded.image.empty()) {
+        yolov8sPreprocess preprocessor;
+        auto plan = LetterboxPlanCache::instance().get(result.decoded.image.size(), imgsz_);
+        torch::Tensor out = acquire_output({1, 3, plan->out_size.height, plan->out_size.width}, torch::kHalf);
+        result.tensor = preprocessor.preprocess(result.decoded.image, *plan, out);
+    }
+    return result;
+}
+
+std::vector<IngestResult> ImageIngest::ingest_batch(const std::vector<std::string>& image_paths) {
+    std::vector<std::future<IngestResult>> futures;
+    futures.reserve(image_paths.size());
+    for (const auto& path : image_paths) {
+        futures.push_back(pool().submit([this, &path] { return to_tensor(decode(path)); }));
+    }
+    std::vector<IngestResult> results;
+    results.reserve(futures.size());
+    for (auto& future : futures) {
+        results.push_back(future.get());
+    }
+    return results;
+}
+
+std::vector<IngestResult> ImageIngest::ingest_batch(const std::vector<std::vector<uint8_t>>& buffers) {
+    std::vector<std::future<IngestResult>> futures;
+    futures.reserve(buffers.size());
+    for (const auto& buffer : buffers) {
+        futures.push_back(pool().submit([this, &buffer] { return to_tensor(decode(buffer)); }));
+    }
+    std::vector<IngestResult> results;
+    results.reserve(futures.size());
+    for (auto& future : futures) {
+        results.push_back(future.get());
+    }
+    return results;
+}
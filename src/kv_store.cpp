@@ -0,0 +1,552 @@
+#include "pb_sdk/kv_store.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+constexpr char kKvMagic[8] = {'P', 'B', 'K', 'V', 'S', 'T', 'R', '1'};
+constexpr uint32_t kKvVersion = 1;
+constexpr const char* kKvSuffix = ".pbkv";
+
+uint64_t align_up(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+size_t prefix_bytes(const PrefixCache& cache) {
+    size_t bytes = cache.token_ids.size() * sizeof(int32_t);
+    for (const auto& layer : cache.k_cache) {
+        bytes += layer.size() * sizeof(uint16_t);
+    }
+    for (const auto& layer : cache.v_cache) {
+        bytes += layer.size() * sizeof(uint16_t);
+    }
+    return bytes;
+}
+
+bool write_all(int fd, const void* data, size_t len, uint64_t offset) {
+    const char* ptr = static_cast<const char*>(data);
+    while (len > 0) {
+        ssize_t n = ::pwrite(fd, ptr, len, static_cast<off_t>(offset));
+        if (n <= 0) {
+            return false;
+        }
+        ptr += n;
+        len -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+bool read_all(int fd, void* data, size_t len, uint64_t offset) {
+    char* ptr = static_cast<char*>(data);
+    while (len > 0) {
+        ssize_t n = ::pread(fd, ptr, len, static_cast<off_t>(offset));
+        if (n <= 0) {
+            return false;
+        }
+        ptr += n;
+        len -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+bool has_suffix(const std::string& name, const std::string& suffix) {
+    return name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/**
+ * @brief 判断是否为崩溃遗留的临时文件：<hash>.pbkv.tmp.<pid>.<seq>，且写入进程已不存在
+ *
+ * @details 同一目录可能有其他进程正在写入，写入进程仍存活或无法判断时不视为遗留
+ */
+bool is_stale_tmp(const std::string& name) {
+    const std::string marker = std::string(kKvSuffix) + ".tmp.";
+    size_t pos = name.find(marker);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    char* end = nullptr;
+    long pid = std::strtol(name.c_str() + pos + marker.size(), &end, 10);
+    if (pid <= 0 || *end != '.' || pid == ::getpid()) {
+        return false;
+    }
+    return ::kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH;
+}
+
+/**
+ * @brief 检查 [offset, offset + count * elem_size) 落在文件内，乘法与加法溢出均视为越界
+ */
+bool span_ok(uint64_t offset, uint64_t count, uint64_t elem_size, uint64_t size) {
+    uint64_t bytes = 0;
+    uint64_t end = 0;
+    return !__builtin_mul_overflow(count, elem_size, &bytes) && !__builtin_add_overflow(offset, bytes, &end) &&
+           end <= size;
+}
+
+/**
+ * @brief 校验文件头与 token、层表两个段的范围
+ */
+bool header_ok(const KvFileHeader& header, uint64_t size) {
+    return std::memcmp(header.magic, kKvMagic, sizeof(kKvMagic)) == 0 && header.version == kKvVersion &&
+           header.file_size == size && span_ok(header.token_offset, header.num_tokens, sizeof(int32_t), size) &&
+           span_ok(header.table_offset, header.num_layers, 4 * sizeof(uint64_t), size);
+}
+
+/**
+ * @brief 只用 pread 读取文件头与 token 序列，用于重建磁盘索引，不映射也不读取 KV 数据
+ */
+bool read_index(const std::string& path, KvFileHeader& header, std::vector<int>& token_ids, size_t& file_size) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    bool ok = ::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(KvFileHeader) &&
+              read_all(fd, &header, sizeof(header), 0) && header_ok(header, static_cast<uint64_t>(st.st_size));
+    if (ok) {
+        file_size = static_cast<size_t>(st.st_size);
+        token_ids.resize(static_cast<size_t>(header.num_tokens));
+        ok = read_all(fd, token_ids.data(), token_ids.size() * sizeof(int32_t), header.token_offset);
+    }
+    ::close(fd);
+    return ok;
+}
+
+/**
+ * @brief fsync 目录，使 rename 与 unlink 在掉电后仍然生效
+ */
+bool sync_dir(const std::string& dir) {
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+}  // namespace
+
+MappedPrefixCache::~MappedPrefixCache()
+{
+    if (m_addr != nullptr) {
+        ::munmap(m_addr, m_size);
+    }
+}
+
+std::shared_ptr<MappedPrefixCache> MappedPrefixCache::open(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(KvFileHeader)) {
+        ::close(fd);
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+
+    std::shared_ptr<MappedPrefixCache> mapped(new MappedPrefixCache());
+    mapped->m_addr = addr;
+    mapped->m_size = size;
+    mapped->m_header = static_cast<const KvFileHeader*>(addr);
+
+    const KvFileHeader& header = *mapped->m_header;
+    if (!header_ok(header, size)) {
+        std::cerr << "Error: invalid kv cache file " << path << std::endl;
+        return nullptr;
+    }
+    for (size_t layer = 0; layer < header.num_layers; ++layer) {
+        const uint64_t* entry = mapped->layer_entry(layer);
+        if (!span_ok(entry[0], entry[1], sizeof(uint16_t), size) || !span_ok(entry[2], entry[3], sizeof(uint16_t), size)) {
+            std::cerr << "Error: truncated kv cache file " << path << std::endl;
+            return nullptr;
+        }
+    }
+    // 后续按层顺序拷贝，提前预读
+    ::madvise(addr, size, MADV_WILLNEED);
+    return mapped;
+}
+
+const uint64_t* MappedPrefixCache::layer_entry(size_t layer) const
+{
+    return reinterpret_cast<const uint64_t*>(static_cast<const char*>(m_addr) + m_header->table_offset) + layer * 4;
+}
+
+const int32_t* MappedPrefixCache::token_ids() const
+{
+    return reinterpret_cast<const int32_t*>(static_cast<const char*>(m_addr) + m_header->token_offset);
+}
+
+const uint16_t* MappedPrefixCache::k_data(size_t layer) const
+{
+    return reinterpret_cast<const uint16_t*>(static_cast<const char*>(m_addr) + layer_entry(layer)[0]);
+}
+
+size_t MappedPrefixCache::k_count(size_t layer) const
+{
+    return layer_entry(layer)[1];
+}
+
+const uint16_t* MappedPrefixCache::v_data(size_t layer) const
+{
+    return reinterpret_cast<const uint16_t*>(static_cast<const char*>(m_addr) + layer_entry(layer)[2]);
+}
+
+size_t MappedPrefixCache::v_count(size_t layer) const
+{
+    return layer_entry(layer)[3];
+}
+
+PrefixCache MappedPrefixCache::to_prefix_cache() const
+{
+    PrefixCache cache;
+    cache.token_ids.assign(token_ids(), token_ids() + num_tokens());
+    cache.k_cache.resize(num_layers());
+    cache.v_cache.resize(num_layers());
+    for (size_t layer = 0; layer < num_layers(); ++layer) {
+        cache.k_cache[layer].assign(k_data(layer), k_data(layer) + k_count(layer));
+        cache.v_cache[layer].assign(v_data(layer), v_data(layer) + v_count(layer));
+    }
+    return cache;
+}
+
+KvPrefixStore::KvPrefixStore(const std::string& dir, size_t ram_budget_bytes, size_t disk_budget_bytes)
+    : m_dir(dir), m_ram_budget(ram_budget_bytes), m_disk_budget(disk_budget_bytes)
+{
+    ::mkdir(m_dir.c_str(), 0755);
+    scan_dir();
+}
+
+uint64_t KvPrefixStore::prefix_hash(const int* token_ids, size_t count)
+{
+    // 64 位 FNV-1a，长度参与哈希
+    uint64_t hash = 0xcbf29ce484222325ull ^ count;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t token = static_cast<uint32_t>(token_ids[i]);
+        for (int b = 0; b < 4; ++b) {
+            hash ^= (token >> (8 * b)) & 0xFF;
+            hash *= 0x100000001b3ull;
+        }
+    }
+    return hash;
+}
+
+bool KvPrefixStore::write_file(const std::string& path, const PrefixCache& cache)
+{
+    if (cache.k_cache.size() != cache.v_cache.size()) {
+        std::cerr << "Error: k_cache and v_cache layer count mismatch" << std::endl;
+        return false;
+    }
+    const size_t num_layers = cache.k_cache.size();
+    KvFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kKvMagic, sizeof(kKvMagic));
+    header.version = kKvVersion;
+    header.num_layers = static_cast<uint32_t>(num_layers);
+    header.prefix_hash = prefix_hash(cache.token_ids.data(), cache.token_ids.size());
+    header.num_tokens = cache.token_ids.size();
+    header.token_offset = align_up(sizeof(KvFileHeader), 64);
+    header.table_offset = align_up(header.token_offset + header.num_tokens * sizeof(int32_t), 64);
+
+    std::vector<uint64_t> table(num_layers * 4);
+    uint64_t offset = align_up(header.table_offset + table.size() * sizeof(uint64_t), kKvFileAlignment);
+    for (size_t layer = 0; layer < num_layers; ++layer) {
+        table[layer * 4 + 0] = offset;
+        table[layer * 4 + 1] = cache.k_cache[layer].size();
+        offset = align_up(offset + cache.k_cache[layer].size() * sizeof(uint16_t), kKvFileAlignment);
+        table[layer * 4 + 2] = offset;
+        table[layer * 4 + 3] = cache.v_cache[layer].size();
+        offset = align_up(offset + cache.v_cache[layer].size() * sizeof(uint16_t), kKvFileAlignment);
+    }
+    header.file_size = offset;
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot create " << path << std::endl;
+        return false;
+    }
+    // 先扩展到完整大小，对齐填充部分为空洞
+    bool ok = ::ftruncate(fd, static_cast<off_t>(header.file_size)) == 0 &&
+              write_all(fd, &header, sizeof(header), 0) &&
+              write_all(fd, cache.token_ids.data(), cache.token_ids.size() * sizeof(int32_t), header.token_offset) &&
+              write_all(fd, table.data(), table.size() * sizeof(uint64_t), header.table_offset);
+    for (size_t layer = 0; ok && layer < num_layers; ++layer) {
+        ok = write_all(fd, cache.k_cache[layer].data(), cache.k_cache[layer].size() * sizeof(uint16_t), table[layer * 4]) &&
+             write_all(fd, cache.v_cache[layer].data(), cache.v_cache[layer].size() * sizeof(uint16_t), table[layer * 4 + 2]);
+    }
+    // rename 之前落盘数据，避免掉电后出现名字正确但内容不完整的文件
+    ok = ok && ::fsync(fd) == 0;
+    ::close(fd);
+    if (!ok) {
+        std::cerr << "Error: Cannot write " << path << std::endl;
+        ::unlink(path.c_str());
+    }
+    return ok;
+}
+
+std::string KvPrefixStore::path_for(uint64_t hash) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+    return m_dir + "/" + name + kKvSuffix;
+}
+
+void KvPrefixStore::scan_dir()
+{
+    DIR* dir = ::opendir(m_dir.c_str());
+    if (dir == nullptr) {
+        return;
+    }
+    struct Found {
+        uint64_t hash;
+        DiskEntry entry;
+        time_t mtime;
+    };
+    std::vector<Found> found;
+    while (struct dirent* item = ::readdir(dir)) {
+        std::string name = item->d_name;
+        if (is_stale_tmp(name)) {
+            // 写入过程中崩溃，rename 之前的临时文件不会再被使用
+            ::unlink((m_dir + "/" + name).c_str());
+            continue;
+        }
+        if (!has_suffix(name, kKvSuffix)) {
+            continue;
+        }
+        std::string path = m_dir + "/" + name;
+        KvFileHeader header;
+        std::vector<int> token_ids;
+        size_t file_size = 0;
+        struct stat st;
+        if (!read_index(path, header, token_ids, file_size) || ::stat(path.c_str(), &st) != 0) {
+            continue;
+        }
+        found.push_back({header.prefix_hash, DiskEntry{path, file_size, std::move(token_ids), 0}, st.st_mtime});
+    }
+    ::closedir(dir);
+
+    // 按修改时间恢复 LRU 顺序
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.mtime < b.mtime; });
+    for (auto& item : found) {
+        item.entry.last_use = ++m_clock;
+        m_stats.disk_bytes += item.entry.bytes;
+        m_tree.insert(item.entry.token_ids.data(), item.entry.token_ids.size());
+        m_disk_index.emplace(item.hash, std::move(item.entry));
+    }
+    evict_disk_locked();
+}
+
+bool KvPrefixStore::put(const PrefixCache& cache)
+{
+    const uint64_t hash = prefix_hash(cache.token_ids.data(), cache.token_ids.size());
+    const std::string path = path_for(hash);
+    // 写临时文件后 rename，读者不会看到写了一半的文件
+    static std::atomic<uint64_t> tmp_seq{0};
+    const std::string tmp = path + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(tmp_seq++);
+    if (!write_file(tmp, cache)) {
+        return false;
+    }
+    struct stat st;
+    if (::rename(tmp.c_str(), path.c_str()) != 0 || ::stat(path.c_str(), &st) != 0) {
+        ::unlink(tmp.c_str());
+        return false;
+    }
+    if (!sync_dir(m_dir)) {
+        std::cerr << "Error: Cannot sync " << m_dir << std::endl;
+    }
+
+    auto shared = std::make_shared<const PrefixCache>(cache);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // 同一哈希已存在时文件已被覆盖，前缀树与索引中的 token 序列也要换成新写入的
+    const std::vector<int>* previous = nullptr;
+    auto it = m_disk_index.find(hash);
+    auto ram = m_ram_index.find(hash);
+    if (it != m_disk_index.end()) {
+        previous = &it->second.token_ids;
+    } else if (ram != m_ram_index.end()) {
+        previous = &ram->second->cache->token_ids;
+    }
+    if (previous == nullptr) {
+        m_tree.insert(cache.token_ids.data(), cache.token_ids.size());
+    } else if (*previous != cache.token_ids) {
+        m_tree.erase(previous->data(), previous->size());
+        m_tree.insert(cache.token_ids.data(), cache.token_ids.size());
+    }
+    if (it != m_disk_index.end()) {
+        m_stats.disk_bytes -= it->second.bytes;
+        it->second.bytes = static_cast<size_t>(st.st_size);
+        it->second.token_ids = cache.token_ids;
+        it->second.last_use = ++m_clock;
+    } else {
+        m_disk_index.emplace(hash, DiskEntry{path, static_cast<size_t>(st.st_size), cache.token_ids, ++m_clock});
+    }
+    m_stats.disk_bytes += static_cast<size_t>(st.st_size);
+    insert_ram_locked(hash, std::move(shared));
+    evict_disk_locked();
+    return true;
+}
+
+void KvPrefixStore::insert_ram_locked(uint64_t hash, std::shared_ptr<const PrefixCache> cache)
+{
+    size_t bytes = prefix_bytes(*cache);
+    if (bytes > m_ram_budget) {
+        return;
+    }
+    auto it = m_ram_index.find(hash);
+    if (it != m_ram_index.end()) {
+        m_stats.ram_bytes -= it->second->bytes;
+        m_ram_lru.erase(it->second);
+        m_ram_index.erase(it);
+    }
+    m_ram_lru.push_front(RamEntry{hash, std::move(cache), bytes});
+    m_ram_index[hash] = m_ram_lru.begin();
+    m_stats.ram_bytes += bytes;
+
+    while (m_stats.ram_bytes > m_ram_budget && !m_ram_lru.empty()) {
+        RamEntry& victim = m_ram_lru.back();
+        m_stats.ram_bytes -= victim.bytes;
+        m_stats.ram_evictions++;
+        uint64_t victim_hash = victim.hash;
+        std::shared_ptr<const PrefixCache> victim_cache = std::move(victim.cache);
+        m_ram_index.erase(victim_hash);
+        m_ram_lru.pop_back();
+        forget_locked(victim_hash, victim_cache->token_ids);
+    }
+}
+
+void KvPrefixStore::evict_disk_locked()
+{
+    while (m_stats.disk_bytes > m_disk_budget && !m_disk_index.empty()) {
+        auto victim = std::min_element(m_disk_index.begin(), m_disk_index.end(), [](const auto& a, const auto& b) {
+            return a.second.last_use < b.second.last_use;
+        });
+        ::unlink(victim->second.path.c_str());
+        m_stats.disk_bytes -= victim->second.bytes;
+        m_stats.disk_evictions++;
+        uint64_t hash = victim->first;
+        std::vector<int> token_ids = std::move(victim->second.token_ids);
+        m_disk_index.erase(victim);
+        forget_locked(hash, token_ids);
+    }
+}
+
+void KvPrefixStore::forget_locked(uint64_t hash, const std::vector<int>& token_ids)
+{
+    // 两层都不再持有时才从前缀树中删除
+    if (m_ram_index.find(hash) == m_ram_index.end() && m_disk_index.find(hash) == m_disk_index.end()) {
+        m_tree.erase(token_ids.data(), token_ids.size());
+    }
+}
+
+std::shared_ptr<const PrefixCache> KvPrefixStore::lookup(uint64_t hash, const int* token_ids, size_t count)
+{
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto ram = m_ram_index.find(hash);
+        if (ram != m_ram_index.end()) {
+            const auto& cached = ram->second->cache->token_ids;
+            if (cached.size() == count && std::equal(cached.begin(), cached.end(), token_ids)) {
+                m_ram_lru.splice(m_ram_lru.begin(), m_ram_lru, ram->second);
+                m_stats.ram_hits++;
+                return ram->second->cache;
+            }
+            return nullptr;
+        }
+        auto disk = m_disk_index.find(hash);
+        if (disk == m_disk_index.end()) {
+            return nullptr;
+        }
+        path = disk->second.path;
+    }
+
+    // 映射与逐层拷贝可能耗时数百毫秒，不持锁进行，其他线程的内存命中与写入不被阻塞
+    auto mapped = MappedPrefixCache::open(path);
+    if (!mapped || mapped->num_tokens() != count ||
+        !std::equal(token_ids, token_ids + count, mapped->token_ids())) {
+        return nullptr;
+    }
+    auto cache = std::make_shared<const PrefixCache>(mapped->to_prefix_cache());
+    mapped.reset();
+    ::utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.disk_hits++;
+    // 拷贝期间条目可能已被淘汰或覆盖，只在索引仍指向同一前缀时提升到内存层
+    auto disk = m_disk_index.find(hash);
+    if (disk != m_disk_index.end() && disk->second.token_ids == cache->token_ids) {
+        disk->second.last_use = ++m_clock;
+        insert_ram_locked(hash, cache);
+    }
+    return cache;
+}
+
+std::shared_ptr<const PrefixCache> KvPrefixStore::get(const std::vector<int>& token_ids)
+{
+    auto cache = lookup(prefix_hash(token_ids.data(), token_ids.size()), token_ids.data(), token_ids.size());
+    if (!cache) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.misses++;
+    }
+    return cache;
+}
+
+std::shared_ptr<const PrefixCache> KvPrefixStore::match_longest(const std::vector<int>& token_ids)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stats.prompt_tokens += token_ids.size();
+    size_t length = m_tree.longest_match(token_ids.data(), token_ids.size());
+    while (length > 0) {
+        lock.unlock();
+        auto cache = lookup(prefix_hash(token_ids.data(), length), token_ids.data(), length);
+        lock.lock();
+        if (cache) {
+            m_stats.reused_tokens += length;
+            return cache;
+        }
+        // 文件损坏等原因装载失败时退到更短的前缀
+        length = m_tree.longest_match(token_ids.data(), length - 1);
+    }
+    m_stats.misses++;
+    return nullptr;
+}
+
+size_t KvPrefixStore::restore(const std::vector<int>& prompt_tokens)
+{
+    auto cache = match_longest(prompt_tokens);
+    if (!cache) {
+        return 0;
+    }
+    load_kv_cache(*cache);
+    return cache->token_ids.size();
+}
+
+KvStoreStats KvPrefixStore::stats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    KvStoreStats stats = m_stats;
+    stats.ram_entries = m_ram_lru.size();
+    stats.disk_entries = m_disk_index.size();
+    return stats;
+}
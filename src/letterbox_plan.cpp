@@ -0,0 +1,273 @@
+#include "yolov8s_pose/letterbox_plan.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "yolov8s_pose/preprocess.h"
+
+namespace {
+
+#if defined(__aarch64__)
+using half_t = __fp16;
+#else
+using half_t = c10::Half;
+#endif
+
+constexpr float kPadValue = 114.0f / 255.0f;
+
+/**
+ * @brief 构建一维定点双线性抽头（与 cv::INTER_LINEAR 的像素中心对齐方式一致）
+ */
+void build_axis(int src_len, int dst_len, std::vector<int>& i0, std::vector<int>& i1, std::vector<int16_t>& w1) {
+    i0.resize(dst_len);
+    i1.resize(dst_len);
+    w1.resize(dst_len);
+    const float scale = static_cast<float>(src_len) / dst_len;
+    for (int d = 0; d < dst_len; ++d) {
+        float s = std::max((d + 0.5f) * scale - 0.5f, 0.0f);
+        int lo = std::min(static_cast<int>(s), src_len - 1);
+        i0[d] = lo;
+        i1[d] = std::min(lo + 1, src_len - 1);
+        w1[d] = static_cast<int16_t>(std::lround((s - lo) * LetterboxPlan::kCoefScale));
+    }
+}
+
+}  // namespace
+
+LetterboxPlan LetterboxPlan::build(const LetterboxKey& key) {
+    if (key.src_w <= 0 || key.src_h <= 0 || key.dst_w <= 0 || key.dst_h <= 0) {
+        throw std::invalid_argument("letterbox dimensions must be positive");
+    }
+    LetterboxPlan plan;
+    plan.key = key;
+
+    float r = std::min(static_cast<float>(key.dst_h) / key.src_h, static_cast<float>(key.dst_w) / key.src_w);
+    if (!key.scaleup) {
+        r = std::min(r, 1.0f);
+    }
+    plan.ratio = cv::Point2f(r, r);
+    plan.unpad = cv::Size(static_cast<int>(std::round(key.src_w * r)), static_cast<int>(std::round(key.src_h * r)));
+    float dw = static_cast<float>(key.dst_w - plan.unpad.width);
+    float dh = static_cast<float>(key.dst_h - plan.unpad.height);
+    if (key.auto_) {
+        dw = std::fmod(dw, static_cast<float>(key.stride));
+        dh = std::fmod(dh, static_cast<float>(key.stride));
+    } else if (key.scaleFill) {
+        dw = 0.0f;
+        dh = 0.0f;
+        plan.unpad = cv::Size(key.dst_w, key.dst_h);
+        plan.ratio = cv::Point2f(static_cast<float>(key.dst_w) / key.src_w, static_cast<float>(key.dst_h) / key.src_h);
+    }
+    dw /= 2.0f;
+    dh /= 2.0f;
+    plan.pad = cv::Point2f(dw, dh);
+    plan.top = static_cast<int>(std::round(dh - 0.1f));
+    plan.bottom = static_cast<int>(std::round(dh + 0.1f));
+    plan.left = static_cast<int>(std::round(dw - 0.1f));
+    plan.right = static_cast<int>(std::round(dw + 0.1f));
+    plan.out_size = cv::Size(plan.unpad.width + plan.left + plan.right, plan.unpad.height + plan.top + plan.bottom);
+
+    build_axis(key.src_w, plan.unpad.width, plan.x0, plan.x1, plan.wx);
+    build_axis(key.src_h, plan.unpad.height, plan.y0, plan.y1, plan.wy);
+    return plan;
+}
+
+std::pair<torch::Tensor, std::vector<float>> LetterboxPlan::ratio_pad(const cv::Size& dst_size) const {
+    float gain = ratio.x;
+    if (!dst_size.empty()) {
+        gain = ratio.x * key.src_w / dst_size.width;
+    }
+    return {torch::tensor(gain), {static_cast<float>(left), static_cast<float>(top)}};
+}
+
+void LetterboxPlan::fill_padding(torch::Tensor& out) const {
+    const int out_w = out_size.width;
+    const int out_h = out_size.height;
+    const size_t plane = static_cast<size_t>(out_w) * out_h;
+    if (!out.defined() || out.scalar_type() != torch::kHalf || out.numel() != static_cast<int64_t>(plane * 3)) {
+        throw std::invalid_argument("output tensor does not match letterbox plan");
+    }
+    half_t* base = reinterpret_cast<half_t*>(out.data_ptr<at::Half>());
+    const half_t pad = static_cast<half_t>(kPadValue);
+    for (int c = 0; c < 3; ++c) {
+        half_t* dst = base + plane * c;
+        std::fill(dst, dst + static_cast<size_t>(top) * out_w, pad);
+        std::fill(dst + static_cast<size_t>(top + unpad.height) * out_w, dst + plane, pad);
+        for (int y = top; y < top + unpad.height; ++y) {
+            half_t* row = dst + static_cast<size_t>(y) * out_w;
+            std::fill(row, row + left, pad);
+            std::fill(row + left + unpad.width, row + out_w, pad);
+        }
+    }
+}
+
+LetterboxPlanCache& LetterboxPlanCache::instance() {
+    static LetterboxPlanCache cache;
+    return cache;
+}
+
+std::shared_ptr<const LetterboxPlan> LetterboxPlanCache::get(const LetterboxKey& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = plans_.find(key);
+    if (it != plans_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return *it->second;
+    }
+    auto plan = std::make_shared<const LetterboxPlan>(LetterboxPlan::build(key));
+    if (plans_.size() >= kMaxPlans) {
+        plans_.erase(lru_.back()->key);
+        lru_.pop_back();
+    }
+    lru_.push_front(plan);
+    plans_.emplace(key, lru_.begin());
+    return plan;
+}
+
+std::shared_ptr<const LetterboxPlan> LetterboxPlanCache::get(const cv::Size& src_size, int imgsz) {
+    LetterboxKey key;
+    key.src_w = src_size.width;
+    key.src_h = src_size.height;
+    key.dst_w = imgsz;
+    key.dst_h = imgsz;
+    return get(key);
+}
+
+void LetterboxPlanCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    plans_.clear();
+    lru_.clear();
+}
+
+torch::Tensor yolov8sPreprocess::preprocess(const cv::Mat& image, const LetterboxPlan& plan, torch::Tensor out) {
+    if (image.type() != CV_8UC3 || image.cols != plan.key.src_w || image.rows != plan.key.src_h) {
+        throw std::invalid_argument("image does not match letterbox plan");
+    }
+    const int out_w = plan.out_size.width;
+    const int out_h = plan.out_size.height;
+    const int new_w = plan.unpad.width;
+    const size_t plane = static_cast<size_t>(out_w) * out_h;
+    if (!out.defined() || out.scalar_type() != torch::kHalf || out.numel() != static_cast<int64_t>(plane * 3)) {
+        out = torch::empty({1, 3, out_h, out_w}, torch::dtype(torch::kHalf));
+    }
+    plan.fill_padding(out);
+    half_t* base = reinterpret_cast<half_t*>(out.data_ptr<at::Half>());
+
+    constexpr int cs = LetterboxPlan::kCoefScale;
+    constexpr float kNorm = 1.0f / (static_cast<float>(cs) * cs * 255.0f);
+
+    // 水平插值后的源行缓存，相邻输出行常共用源行
+    std::vector<int32_t> h0(static_cast<size_t>(new_w) * 3), h1(static_cast<size_t>(new_w) * 3);
+    int cached0 = -1;
+    int cached1 = -1;
+    auto resample_row = [&](int sy, int32_t* dst) {
+        const uint8_t* src = image.ptr<uint8_t>(sy);
+        for (int dx = 0; dx < new_w; ++dx) {
+            const uint8_t* p0 = src + plan.x0[dx] * 3;
+            const uint8_t* p1 = src + plan.x1[dx] * 3;
+            const int32_t w1 = plan.wx[dx];
+            const int32_t w0 = cs - w1;
+            dst[dx * 3] = p0[0] * w0 + p1[0] * w1;
+            dst[dx * 3 + 1] = p0[1] * w0 + p1[1] * w1;
+            dst[dx * 3 + 2] = p0[2] * w0 + p1[2] * w1;
+        }
+    };
+
+    for (int dy = 0; dy < plan.unpad.height; ++dy) {
+        const int sy0 = plan.y0[dy];
+        const int sy1 = plan.y1[dy];
+        if (sy0 != cached0) {
+            if (sy0 == cached1) {
+                std::swap(h0, h1);
+                std::swap(cached0, cached1);
+            } else {
+                resample_row(sy0, h0.data());
+                cached0 = sy0;
+            }
+        }
+        if (sy1 != cached1) {
+            resample_row(sy1, h1.data());
+            cached1 = sy1;
+        }
+
+        const int32_t w1 = plan.wy[dy];
+        const int32_t w0 = cs - w1;
+        const size_t offset = static_cast<size_t>(plan.top + dy) * out_w + plan.left;
+        // BGR -> RGB：源通道 c 写入输出平面 2 - c
+        for (int c = 0; c < 3; ++c) {
+            half_t* dst = base + plane * (2 - c) + offset;
+            const int32_t* a = h0.data() + c;
+            const int32_t* b = h1.data() + c;
+            for (int dx = 0; dx < new_w; ++dx) {
+                dst[dx] = static_cast<half_t>(static_cast<float>(a[dx * 3] * w0 + b[dx * 3] * w1) * kNorm);
+            }
+        }
+    }
+    return out;
+}
+
+torch::Tensor yolov8sPreprocess::preprocess_u8(const cv::Mat& image, const LetterboxPlan& plan, torch::Tensor out) {
+    if (image.type() != CV_8UC3 || image.cols != plan.key.src_w || image.rows != plan.key.src_h) {
+        throw std::invalid_argument("image does not match letterbox plan");
+    }
+    const int out_w = plan.out_size.width;
+    const int out_h = plan.out_size.height;
+    const int new_w = plan.unpad.width;
+    const size_t row_bytes = static_cast<size_t>(out_w) * 3;
+    if (!out.defined() || out.scalar_type() != torch::kUInt8 ||
+        out.numel() != static_cast<int64_t>(row_bytes * out_h)) {
+        out = torch::empty({1, out_h, out_w, 3}, torch::dtype(torch::kUInt8));
+    }
+    uint8_t* base = out.data_ptr<uint8_t>();
+    const uint8_t pad = static_cast<uint8_t>(kPadValue * 255.0f + 0.5f);
+    std::fill(base, base + row_bytes * plan.top, pad);
+    std::fill(base + row_bytes * (plan.top + plan.unpad.height), base + row_bytes * out_h, pad);
+
+    constexpr int cs = LetterboxPlan::kCoefScale;
+    constexpr int32_t kRound = 1 << (LetterboxPlan::kCoefBits * 2 - 1);
+    std::vector<int32_t> h0(static_cast<size_t>(new_w) * 3), h1(static_cast<size_t>(new_w) * 3);
+    int cached0 = -1;
+    int cached1 = -1;
+    auto resample_row = [&](int sy, int32_t* dst) {
+        const uint8_t* src = image.ptr<uint8_t>(sy);
+        for (int dx = 0; dx < new_w; ++dx) {
+            const uint8_t* p0 = src + plan.x0[dx] * 3;
+            const uint8_t* p1 = src + plan.x1[dx] * 3;
+            const int32_t w1 = plan.wx[dx];
+            const int32_t w0 = cs - w1;
+            // 写入时即完成 BGR -> RGB
+            dst[dx * 3] = p0[2] * w0 + p1[2] * w1;
+            dst[dx * 3 + 1] = p0[1] * w0 + p1[1] * w1;
+            dst[dx * 3 + 2] = p0[0] * w0 + p1[0] * w1;
+        }
+    };
+
+    for (int dy = 0; dy < plan.unpad.height; ++dy) {
+        const int sy0 = plan.y0[dy];
+        const int sy1 = plan.y1[dy];
+        if (sy0 != cached0) {
+            if (sy0 == cached1) {
+                std::swap(h0, h1);
+                std::swap(cached0, cached1);
+            } else {
+                resample_row(sy0, h0.data());
+                cached0 = sy0;
+            }
+        }
+        if (sy1 != cached1) {
+            resample_row(sy1, h1.data());
+            cached1 = sy1;
+        }
+
+        const int32_t w1 = plan.wy[dy];
+        const int32_t w0 = cs - w1;
+        uint8_t* row = base + row_bytes * (plan.top + dy);
+        std::fill(row, row + plan.left * 3, pad);
+        std::fill(row + (plan.left + new_w) * 3, row + row_bytes, pad);
+        uint8_t* dst = row + plan.left * 3;
+        for (int i = 0; i < new_w * 3; ++i) {
+            dst[i] = static_cast<uint8_t>((h0[i] * w0 + h1[i] * w1 + kRound) >> (LetterboxPlan::kCoefBits * 2));
+        }
+    }
+    return out;
+}
@@ -2,38 +2,86 @@
 #include <iomanip>
 #include <string>
 
+#include "pb_sdk/cpu_affinity.h"
+#include "pb_sdk/model_desc.h"
 #include "pb_sdk/pb_infer_api.h"
 #include "pb_sdk/qm_runtime.h"
 
-#include "yolov8s/preprocess.h"
-#include "yolov8s/postprocess.h"
+#include "yolov8s_pose/image_ingest.h"
+#include "yolov8s_pose/preprocess.h"
+#include "yolov8s_pose/postprocess.h"
 
 
 
-void yolov8s_det(std::string model_path){
+void yolov8s_det(std::string model_path, bool uint8_input){
     std::string image_path = "data/inputc.jpg";
     // std::string model_path = "model/yolov8s.pbnn";
 
+    // 从模型描述获取输入尺寸与数据类型，不再硬编码
+    // --uint8 只修改本地副本，不覆盖全局注册的模型描述
+    ModelDesc desc = describe_model(YOLOV8S).value();
+    if (uint8_input) {
+        desc.inputs[0].data_type = "uint8_t";
+        desc.inputs[0].layout = "NHWC";
+    }
+    const TensorDesc& input_desc = desc.inputs[0];
+    const int imgsz = static_cast<int>(input_desc.shape[3]);
+
+    // 按 pb_infer.json 的 affinity 段绑核，避免与相机解码等线程争抢
+    AffinityConfig affinity = load_affinity_config("pb_infer/pb_infer.json");
+    verify_cpu_isolation("decode", affinity.decode_cpus);
+    verify_cpu_isolation("preprocess", affinity.preprocess_cpus);
+    verify_cpu_isolation("postprocess", affinity.postprocess_cpus);
+
+    // 模型在绑核之前初始化：库内部创建的线程继承调用线程的 CPU 掩码，
+    // 否则会被限制在 decode/preprocess 核上
+    int model_id = YOLOV8S;
+    ModelHandler model;
+    model.init(model_id, model_path);
+
+    // 单张图像在调用线程解码，解码阶段切到 decode 核，预处理前再切到 preprocess 核
+    pin_current_thread(affinity.decode_cpus);
+    ImageIngest ingest(imgsz, 0, affinity.decode_cpus, affinity.buffer_node);
+    DecodedImage decoded = ingest.decode(image_path);
+    if (decoded.image.empty()) {
+        return;
+    }
+
     //preprocess
     std::cout << "Running preprocess..." << std::endl;
+    pin_current_thread(affinity.preprocess_cpus);
     std::shared_ptr<yolov8sPreprocess> preprocessor = std::make_shared<yolov8sPreprocess>();
-    cv::Mat img = cv::imread(image_path, cv::IMREAD_COLOR);
-    torch::Tensor img_tensor = preprocessor->preprocess(img, 640);
+    cv::Mat img = decoded.image;
+    auto plan = LetterboxPlanCache::instance().get(img.size(), imgsz);
+    const int out_h = plan->out_size.height;
+    const int out_w = plan->out_size.width;
+    // uint8 输入：归一化已折叠进模型首层，客户端只发送 letterbox 后的 NHWC 像素
+    torch::Tensor img_tensor = uint8_input
+        ? preprocessor->preprocess_u8(img, *plan, ingest.acquire_output({1, out_h, out_w, 3}, torch::kUInt8))
+        : preprocessor->preprocess(img, *plan, ingest.acquire_output({1, 3, out_h, out_w}, torch::kHalf));
     std::cout << "Preprocess OK." << std::endl;
 
     //infer
     std::cout << "Running execute..." << std::endl;
-    int model_id = YOLOV8S;
-    ModelHandler model;
-    model.init(model_id, model_path);
     CnnChatCompletions request;
     CnnChatData part;
-    part.data_type = "float16";
+    // 类型与形状取自实际张量，校验才能发现预处理输出与模型描述不一致
+    part.data_type = img_tensor.scalar_type() == torch::kUInt8 ? "uint8_t" : "float16";
     part.data_shape = img_tensor.sizes().vec();
+    if (uint8_input) {
+        // NHWC 像素按逻辑形状 NCHW 上报，实际排布由 TensorDesc::layout 说明
+        part.data_shape = {part.data_shape[0], part.data_shape[3], part.data_shape[1], part.data_shape[2]};
+    }
     part.data.resize(img_tensor.nbytes());
     std::memcpy(part.data.data(), img_tensor.data_ptr(), img_tensor.nbytes());
+    std::cout << "Input " << part.data_type << " bytes: " << part.data.size() << std::endl;
     request.data_info.push_back(std::move(part));
     request.case_name = "image";
+    std::string error;
+    if (validate_request(desc, request, &error) != PBNN_SUCCESS) {
+        std::cerr << "Invalid request: " << error << std::endl;
+        return;
+    }
     model.input(request);
     model.execute();
     auto ret = model.output();
@@ -42,6 +90,7 @@ void yolov8s_det(std::string model_path){
 
     //postprocess
     std::cout << "Running postprocess..." << std::endl;
+    pin_current_thread(affinity.postprocess_cpus);
     bool draw_save_image = true;
     DetectionResult det_result;
     std::shared_ptr<YoloV8sPostprocess> postprocessor = std::make_shared<YoloV8sPostprocess>();
@@ -49,17 +98,24 @@ void yolov8s_det(std::string model_path){
         std::cout << "YoloV8sDetector postprocessor is nullptr!";
     }
     postprocessor->Init();
-    postprocessor->postprocess(result.data_info[0].data.data(), img, det_result, draw_save_image);
+    // 不再全尺寸解码原图：DCT 缩放解码的图像放大到 SOF 头中的原始尺寸作为绘制画布，
+    // 检测框按预处理计划的缩放与填充还原到原始分辨率
+    cv::Mat canvas = img;
+    if (decoded.scale_denom > 1) {
+        cv::resize(img, canvas, decoded.src_size, 0, 0, cv::INTER_LINEAR);
+    }
+    postprocessor->postprocess(result.data_info[0].data.data(), *plan, canvas, det_result, draw_save_image);
     std::cout << "Postprocess OK." << std::endl;
 
 }
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <model_path>\n";
+        std::cerr << "Usage: " << argv[0] << " <model_path> [--uint8]\n";
         return -1;
     }
 
     std::string model_path = argv[1];
-    yolov8s_det(model_path);
+    bool uint8_input = argc > 2 && std::string(argv[2]) == "--uint8";
+    yolov8s_det(model_path, uint8_input);
     return 0;
 }
\ No newline at end of file
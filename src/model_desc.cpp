@@ -0,0 +1,92 @@
+#include "pb_sdk/model_desc.h"
+
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+std::mutex g_desc_mutex;
+
+/**
+ * @brief 内置模型描述，与各示例的输入输出约定一致
+ */
+std::unordered_map<int, ModelDesc>& desc_table() {
+    static std::unordered_map<int, ModelDesc> table = {
+        // 输入为预处理输出的 NCHW float16；输出逻辑形状 [1, 38, 420, 20]，NPU 按 [1, 420, 20, 38] 排布
+        {YOLOV8S, {YOLOV8S, "yolov8s",
+                   {{"images", {1, 3, 640, 640}, "float16", ""}},
+                   {{"Reshape_output_0", {1, 38, 420, 20}, "float16", "NHWC"}},
+                   1}},
+    };
+    return table;
+}
+
+}  // namespace
+
+size_t data_type_size(const std::string& data_type) {
+    if (data_type == "float16") {
+        return 2;
+    } else if (data_type == "uint8_t" || data_type == "int8_t") {
+        return 1;
+    } else if (data_type == "float32") {
+        return 4;
+    }
+    return 0;
+}
+
+size_t TensorDesc::nbytes() const {
+    size_t count = 1;
+    for (auto dim : shape) {
+        count *= static_cast<size_t>(dim);
+    }
+    return count * data_type_size(data_type);
+}
+
+std::optional<ModelDesc> describe_model(int model) {
+    std::lock_guard<std::mutex> lock(g_desc_mutex);
+    auto it = desc_table().find(model);
+    if (it == desc_table().end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void register_model_desc(const ModelDesc& desc) {
+    std::lock_guard<std::mutex> lock(g_desc_mutex);
+    desc_table()[desc.model] = desc;
+}
+
+int validate_request(const ModelDesc& desc, const CnnChatCompletions& request, std::string* error) {
+    std::ostringstream ss;
+    if (request.data_info.size() != desc.inputs.size()) {
+        ss << desc.name << ": expected " << desc.inputs.size() << " inputs, got " << request.data_info.size();
+    } else {
+        for (size_t i = 0; i < desc.inputs.size(); ++i) {
+            const TensorDesc& expect = desc.inputs[i];
+            const CnnChatData& part = request.data_info[i];
+            if (part.data_type != expect.data_type) {
+                ss << desc.name << " input " << i << ": data type " << part.data_type
+                   << " does not match " << expect.data_type;
+                break;
+            }
+            if (part.data_shape != expect.shape) {
+                ss << desc.name << " input " << i << ": shape mismatch";
+                break;
+            }
+            if (part.data.size() != expect.nbytes()) {
+                ss << desc.name << " input " << i << ": expected " << expect.nbytes()
+                   << " bytes, got " << part.data.size();
+                break;
+            }
+        }
+    }
+    std::string message = ss.str();
+    if (message.empty()) {
+        return PBNN_SUCCESS;
+    }
+    if (error != nullptr) {
+        *error = message;
+    }
+    return PBNN_INVALID_ARGUMENT;
+}
@@ -0,0 +1,79 @@
+#include "yolov8s_pose/postprocess.h"
+
+#include <string>
+#include <vector>
+
+#include "pb_sdk/model_desc.h"
+
+bool YoloV8sPostprocess::postprocess(
+    uint8_t* out_data, const LetterboxPlan& plan, cv::Mat& cv_image, DetectionResult &det_result,
+    bool draw_save_image) {
+    if (out_data == nullptr || cv_image.empty()) {
+        std::cerr << "postprocess: empty output or image" << std::endl;
+        return false;
+    }
+    return postProcessAnnotate(out_data, det_result, cv_image, plan, kConfThres, kIouThres, kMaxDet,
+                               draw_save_image) == 0;
+}
+
+int YoloV8sPostprocess::postProcessAnnotate(
+    uint8_t* Reshape_output_0, DetectionResult &det_result,
+    cv::Mat& image,
+    const LetterboxPlan& plan,
+    float conf_thres,
+    float iou_thres,
+    int max_det, bool draw_save_image) {
+    // 输出形状与排布取自模型描述：逻辑形状为 NCHW，NHWC 排布时按原生形状读取后转置
+    const TensorDesc& output = describe_model(YOLOV8S).value().outputs[0];
+    std::vector<int64_t> shape = output.shape;
+    const bool nhwc = output.layout == "NHWC";
+    if (nhwc) {
+        shape = {shape[0], shape[2], shape[3], shape[1]};
+    }
+    torch::Tensor pred = ptr_to_tensor(Reshape_output_0, torch::kHalf, shape);
+    if (nhwc) {
+        pred = pred.permute({0, 3, 1, 2}).contiguous();
+    }
+    std::vector<torch::Tensor> out = non_max_suppression(
+        pred, conf_thres, iou_thres, classes_, false, false, max_det,
+        static_cast<int>(names_.size()), 0.05f, 30000, 7680, true, false);
+    if (out.empty()) {
+        std::cout << "No detections! " << std::endl;
+        return 0;
+    }
+
+    // 缩放比例与填充量来自预处理计划，img1_shape 为计划的输出尺寸
+    const std::vector<int> img1_shape{plan.out_size.height, plan.out_size.width};
+    const std::vector<int> img0_shape{image.rows, image.cols};
+    const auto ratio_pad = plan.ratio_pad(image.size());
+
+    torch::Tensor det = out[0];
+    bool drawn = false;
+    for (int64_t i = 0; i < det.size(0); ++i) {
+        torch::Tensor row = det[i];
+        const float conf = row[4].item<float>();
+        const int cls = static_cast<int>(row[5].item<float>());
+        const std::string label = names_[cls] + " " + std::to_string(conf).substr(0, 4);
+        torch::Tensor box = scale_boxes(img1_shape, row.slice(0, 0, 4).unsqueeze(0), img0_shape,
+                                        ratio_pad, true, false)
+                                .squeeze(0);
+        std::cout << "conf " << conf << " cls " << cls << " label " << label
+                  << " box x1 " << box[0].item<float>() << " box y1 " << box[1].item<float>()
+                  << " box x2 " << box[2].item<float>() << " box y2 " << box[3].item<float>() << std::endl;
+        if (conf > conf_thres) {
+            det_result.label = names_[cls];
+            det_result.conf = conf;
+            det_result.type = "hand";
+            det_result.box = {box[0].item<int>(), box[1].item<int>(), box[2].item<int>(), box[3].item<int>()};
+            if (draw_save_image) {
+                draw_box_label(image, box, label, colors(cls));
+                drawn = true;
+            }
+        }
+    }
+    // 所有框绘制完成后只保存一张结果图
+    if (drawn) {
+        saveImageWithTimestamp(image, "./results");
+    }
+    return 0;
+}
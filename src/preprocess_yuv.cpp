@@ -0,0 +1,172 @@
+#include "yolov8s_pose/preprocess.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+#if defined(__aarch64__)
+using half_t = __fp16;
+#else
+using half_t = c10::Half;
+#endif
+
+inline float lerp2(const uint8_t* row0, const uint8_t* row1, int x0, int x1, int32_t wx, int32_t wy) {
+    constexpr int32_t cs = LetterboxPlan::kCoefScale;
+    constexpr float kNorm = 1.0f / (static_cast<float>(cs) * cs);
+    int32_t top = row0[x0] * (cs - wx) + row0[x1] * wx;
+    int32_t bottom = row1[x0] * (cs - wx) + row1[x1] * wx;
+    return static_cast<float>(top * (cs - wy) + bottom * wy) * kNorm;
+}
+
+/**
+ * @brief BT.601 有限范围 YUV -> RGB 并归一化，连续内存上的纯算术循环，便于编译器向量化
+ */
+void yuv_row_to_rgb(const float* y, const float* u, const float* v, int len,
+                    half_t* r_out, half_t* g_out, half_t* b_out) {
+    constexpr float kInv255 = 1.0f / 255.0f;
+    for (int x = 0; x < len; ++x) {
+        float c = (y[x] - 16.0f) * 1.164f;
+        float d = u[x] - 128.0f;
+        float e = v[x] - 128.0f;
+        float r = std::min(std::max(c + 1.596f * e, 0.0f), 255.0f);
+        float g = std::min(std::max(c - 0.813f * e - 0.391f * d, 0.0f), 255.0f);
+        float b = std::min(std::max(c + 2.018f * d, 0.0f), 255.0f);
+        r_out[x] = static_cast<half_t>(r * kInv255);
+        g_out[x] = static_cast<half_t>(g * kInv255);
+        b_out[x] = static_cast<half_t>(b * kInv255);
+    }
+}
+
+void validate_frame(const YuvFrame& frame) {
+    if (frame.width <= 0 || frame.height <= 0) {
+        throw std::invalid_argument("YUV frame dimensions must be positive");
+    }
+    int plane_count = frame.format == YuvFormat::I420 ? 3 : (frame.format == YuvFormat::NV12 ? 2 : 1);
+    for (int i = 0; i < plane_count; ++i) {
+        if (frame.planes[i] == nullptr) {
+            throw std::invalid_argument("YUV frame plane is null");
+        }
+    }
+    if (frame.format != YuvFormat::I420 && (frame.width % 2 != 0)) {
+        throw std::invalid_argument("NV12/YUYV frame width must be even");
+    }
+}
+
+}  // namespace
+
+torch::Tensor yolov8sPreprocess::preprocess(const YuvFrame& frame, int imgsz) {
+    validate_frame(frame);
+    auto plan = LetterboxPlanCache::instance().get(cv::Size(frame.width, frame.height), imgsz);
+    return preprocess(frame, *plan);
+}
+
+torch::Tensor yolov8sPreprocess::preprocess(const YuvFrame& frame, const LetterboxPlan& plan, torch::Tensor out) {
+    validate_frame(frame);
+    if (frame.width != plan.key.src_w || frame.height != plan.key.src_h) {
+        throw std::invalid_argument("YUV frame does not match letterbox plan");
+    }
+    const int w = frame.width;
+    const int y_stride = frame.strides[0] > 0 ? frame.strides[0]
+                         : (frame.format == YuvFormat::YUYV ? w * 2 : w);
+    const int c_stride = frame.strides[1] > 0 ? frame.strides[1]
+                         : (frame.format == YuvFormat::I420 ? (w + 1) / 2 : w);
+    const int v_stride = frame.strides[2] > 0 ? frame.strides[2] : c_stride;
+
+    const int out_w = plan.out_size.width;
+    const int out_h = plan.out_size.height;
+    const int new_w = plan.unpad.width;
+    const size_t plane = static_cast<size_t>(out_w) * out_h;
+    if (!out.defined() || out.scalar_type() != torch::kHalf || out.numel() != static_cast<int64_t>(plane * 3)) {
+        out = torch::empty({1, 3, out_h, out_w}, torch::dtype(torch::kHalf));
+    }
+    plan.fill_padding(out);
+    half_t* base = reinterpret_cast<half_t*>(out.data_ptr<at::Half>());
+
+    std::vector<float> y_row(new_w), u_row(new_w), v_row(new_w);
+    for (int dy = 0; dy < plan.unpad.height; ++dy) {
+        const int sy0 = plan.y0[dy];
+        const int sy1 = plan.y1[dy];
+        const int32_t wy = plan.wy[dy];
+
+        if (frame.format == YuvFormat::YUYV) {
+            const uint8_t* row0 = frame.planes[0] + static_cast<size_t>(sy0) * y_stride;
+            const uint8_t* row1 = frame.planes[0] + static_cast<size_t>(sy1) * y_stride;
+            for (int dx = 0; dx < new_w; ++dx) {
+                const int x0 = plan.x0[dx];
+                // 打包格式中 Y 位于偶数字节
+                y_row[dx] = lerp2(row0, row1, x0 * 2, plan.x1[dx] * 2, plan.wx[dx], wy);
+                const uint8_t* chroma = row0 + (x0 & ~1) * 2;
+                u_row[dx] = chroma[1];
+                v_row[dx] = chroma[3];
+            }
+        } else {
+            const uint8_t* row0 = frame.planes[0] + static_cast<size_t>(sy0) * y_stride;
+            const uint8_t* row1 = frame.planes[0] + static_cast<size_t>(sy1) * y_stride;
+            const int cy = sy0 >> 1;
+            for (int dx = 0; dx < new_w; ++dx) {
+                y_row[dx] = lerp2(row0, row1, plan.x0[dx], plan.x1[dx], plan.wx[dx], wy);
+            }
+            if (frame.format == YuvFormat::NV12) {
+                const uint8_t* uv = frame.planes[1] + static_cast<size_t>(cy) * c_stride;
+                for (int dx = 0; dx < new_w; ++dx) {
+                    const int cx = (plan.x0[dx] >> 1) * 2;
+                    u_row[dx] = uv[cx];
+                    v_row[dx] = uv[cx + 1];
+                }
+            } else {
+                const uint8_t* u = frame.planes[1] + static_cast<size_t>(cy) * c_stride;
+                const uint8_t* v = frame.planes[2] + static_cast<size_t>(cy) * v_stride;
+                for (int dx = 0; dx < new_w; ++dx) {
+                    const int cx = plan.x0[dx] >> 1;
+                    u_row[dx] = u[cx];
+                    v_row[dx] = v[cx];
+                }
+            }
+        }
+
+        const size_t offset = static_cast<size_t>(plan.top + dy) * out_w + plan.left;
+        yuv_row_to_rgb(y_row.data(), u_row.data(), v_row.data(), new_w,
+                       base + offset, base + plane + offset, base + plane * 2 + offset);
+    }
+    return out;
+}
+
+torch::Tensor yolov8sPreprocess::preprocess_nv12(const uint8_t* y, const uint8_t* uv, int width, int height,
+                                                 int imgsz, int y_stride, int uv_stride) {
+    YuvFrame frame;
+    frame.format = YuvFormat::NV12;
+    frame.width = width;
+    frame.height = height;
+    frame.planes[0] = y;
+    frame.planes[1] = uv;
+    frame.strides[0] = y_stride;
+    frame.strides[1] = uv_stride;
+    return preprocess(frame, imgsz);
+}
+
+torch::Tensor yolov8sPreprocess::preprocess_i420(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                                                 int width, int height, int imgsz, int y_stride, int uv_stride) {
+    YuvFrame frame;
+    frame.format = YuvFormat::I420;
+    frame.width = width;
+    frame.height = height;
+    frame.planes[0] = y;
+    frame.planes[1] = u;
+    frame.planes[2] = v;
+    frame.strides[0] = y_stride;
+    frame.strides[1] = uv_stride;
+    frame.strides[2] = uv_stride;
+    return preprocess(frame, imgsz);
+}
+
+torch::Tensor yolov8sPreprocess::preprocess_yuyv(const uint8_t* yuyv, int width, int height, int imgsz, int stride) {
+    YuvFrame frame;
+    frame.format = YuvFormat::YUYV;
+    frame.width = width;
+    frame.height = height;
+    frame.planes[0] = yuyv;
+    frame.strides[0] = stride;
+    return preprocess(frame, imgsz);
+}
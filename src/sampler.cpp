@@ -0,0 +1,275 @@
+#include "pb_sdk/sampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+constexpr int kRadixBits = 12;
+constexpr int kRadixShift = 32 - kRadixBits;
+
+/**
+ * @brief float 映射为保序的 uint32：浮点值越大，键越大
+ */
+inline uint32_t order_key(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+inline bool candidate_before(float a_logit, int a_token, float b_logit, int b_token) {
+    return a_logit > b_logit || (a_logit == b_logit && a_token < b_token);
+}
+
+}  // namespace
+
+SamplerConfig SamplerConfig::from_request(const ChatCompletionsRequest& request)
+{
+    SamplerConfig config;
+    config.temperature = request.temperature;
+    config.top_k = request.top_k;
+    config.meta_top_k = request.meta_top_k;
+    config.top_p = request.top_p;
+    config.repetition_penalty = request.repetition_penalty;
+    config.presence_penalty = request.presence_penalty;
+    config.frequency_penalty = request.frequency_penalty;
+    config.seed = request.seed;
+    return config;
+}
+
+TokenSampler::TokenSampler(int vocab_size, const SamplerConfig& config)
+    : m_vocab_size(vocab_size),
+      m_config(config),
+      m_counts(vocab_size, 0),
+      m_seen_flag(vocab_size, 0),
+      m_histogram(1u << kRadixBits, 0),
+      m_mass(1u << kRadixBits, 0.0f),
+      m_rng(config.seed ? static_cast<uint64_t>(*config.seed) : std::random_device{}())
+{
+    if (vocab_size <= 0) {
+        throw std::invalid_argument("TokenSampler: vocab_size must be positive");
+    }
+}
+
+void TokenSampler::reset()
+{
+    for (int token : m_seen) {
+        m_counts[token] = 0;
+        m_seen_flag[token] = 0;
+    }
+    m_seen.clear();
+}
+
+void TokenSampler::mark_seen(int token)
+{
+    if (!m_seen_flag[token]) {
+        m_seen_flag[token] = 1;
+        m_seen.push_back(token);
+    }
+}
+
+void TokenSampler::accept_prompt(int token)
+{
+    if (token < 0 || token >= m_vocab_size) {
+        return;
+    }
+    mark_seen(token);
+}
+
+void TokenSampler::accept(int token)
+{
+    if (token < 0 || token >= m_vocab_size) {
+        return;
+    }
+    m_counts[token]++;
+    mark_seen(token);
+}
+
+void TokenSampler::apply_penalties(float* logits) const
+{
+    const float rp = m_config.repetition_penalty;
+    for (int token : m_seen) {
+        float logit = logits[token];
+        if (rp != 1.0f) {
+            logit = logit > 0.0f ? logit / rp : logit * rp;
+        }
+        const int count = m_counts[token];
+        if (count > 0) {
+            logit -= m_config.frequency_penalty * count + m_config.presence_penalty;
+        }
+        logits[token] = logit;
+    }
+}
+
+void TokenSampler::select_top_k(const float* logits, int k)
+{
+    m_candidates.clear();
+
+    // 第一遍：按键的高 12 位统计直方图
+    std::fill(m_histogram.begin(), m_histogram.end(), 0u);
+    for (int i = 0; i < m_vocab_size; ++i) {
+        m_histogram[order_key(logits[i]) >> kRadixShift]++;
+    }
+    // 从最高桶向下累加，找到包含第 k 大元素的桶
+    uint32_t bucket = (1u << kRadixBits) - 1;
+    uint32_t count = 0;
+    for (;; --bucket) {
+        count += m_histogram[bucket];
+        if (count >= static_cast<uint32_t>(k) || bucket == 0) {
+            break;
+        }
+    }
+
+    // 第二遍：只收集该桶及以上的元素，通常只比 k 略多
+    const uint32_t threshold = bucket << kRadixShift;
+    m_candidates.reserve(count);
+    for (int i = 0; i < m_vocab_size; ++i) {
+        if (order_key(logits[i]) >= threshold) {
+            m_candidates.push_back({logits[i], i});
+        }
+    }
+    if (m_candidates.size() > static_cast<size_t>(k)) {
+        std::nth_element(m_candidates.begin(), m_candidates.begin() + (k - 1), m_candidates.end(),
+                         [](const Candidate& a, const Candidate& b) {
+                             return candidate_before(a.logit, a.token, b.logit, b.token);
+                         });
+        m_candidates.resize(k);
+    }
+}
+
+float TokenSampler::select_by_mass(const float* logits)
+{
+    m_candidates.clear();
+    const float max_logit = *std::max_element(logits, logits + m_vocab_size);
+    const float inv_temp = 1.0f / m_config.temperature;
+    // min-p 的概率下限 min_p * p_max 换算为 logit 下限：logit >= max + T * ln(min_p)
+    const float floor = m_config.min_p > 0.0f
+                            ? max_logit + m_config.temperature * std::log(std::min(m_config.min_p, 1.0f))
+                            : -std::numeric_limits<float>::infinity();
+
+    uint32_t threshold = 0;
+    float total = 0.0f;
+    if (m_config.top_p < 1.0f) {
+        // 按键的高 12 位累加未归一化概率，从最高桶向下找到累计质量达到 top_p 的桶
+        std::fill(m_mass.begin(), m_mass.end(), 0.0f);
+        for (int i = 0; i < m_vocab_size; ++i) {
+            const float weight = std::exp((logits[i] - max_logit) * inv_temp);
+            m_mass[order_key(logits[i]) >> kRadixShift] += weight;
+            total += weight;
+        }
+        const float limit = m_config.top_p * total;
+        uint32_t bucket = (1u << kRadixBits) - 1;
+        float cumulative = 0.0f;
+        for (;; --bucket) {
+            cumulative += m_mass[bucket];
+            if (cumulative >= limit || bucket == 0) {
+                break;
+            }
+        }
+        threshold = bucket << kRadixShift;
+    }
+
+    for (int i = 0; i < m_vocab_size; ++i) {
+        if (logits[i] >= floor && order_key(logits[i]) >= threshold) {
+            m_candidates.push_back({logits[i], i});
+        }
+    }
+    return total;
+}
+
+double TokenSampler::next_uniform()
+{
+    // 不依赖标准库分布的实现细节，保证相同 seed 在不同平台结果一致
+    return static_cast<double>(m_rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int TokenSampler::sample(float* logits)
+{
+    apply_penalties(logits);
+
+    if (m_config.temperature <= 0.0f) {
+        return static_cast<int>(std::max_element(logits, logits + m_vocab_size) - logits);
+    }
+
+    int k = m_config.top_k;
+    if (m_config.meta_top_k > 0 && (k <= 0 || k > m_config.meta_top_k)) {
+        k = m_config.meta_top_k;
+    }
+    // 候选集合为整个词表时 top-p 的分母取全词表概率和，否则取候选概率和
+    float total = 0.0f;
+    bool truncate = true;
+    if (k > 0 && k < m_vocab_size) {
+        select_top_k(logits, k);
+    } else {
+        total = select_by_mass(logits);
+        truncate = m_config.top_p < 1.0f || m_config.min_p > 0.0f;
+    }
+    // 需要截断时按 logit 降序，token 升序打破平局，保证确定性；不截断时按 token 顺序采样，无需排序整个词表
+    if (truncate) {
+        std::sort(m_candidates.begin(), m_candidates.end(), [](const Candidate& a, const Candidate& b) {
+            return candidate_before(a.logit, a.token, b.logit, b.token);
+        });
+    }
+
+    const float inv_temp = 1.0f / m_config.temperature;
+    const float max_logit = std::max_element(m_candidates.begin(), m_candidates.end(),
+                                              [](const Candidate& a, const Candidate& b) {
+                                                  return a.logit < b.logit;
+                                              })->logit;
+    const size_t n = m_candidates.size();
+    m_probs.resize(n);
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        m_probs[i] = std::exp((m_candidates[i].logit - max_logit) * inv_temp);
+        sum += m_probs[i];
+    }
+    if (total <= 0.0f) {
+        total = sum;
+    }
+
+    // top-p 与 min-p 截断，候选已降序
+    size_t keep = n;
+    if (m_config.top_p < 1.0f) {
+        const float limit = m_config.top_p * total;
+        float cumulative = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            cumulative += m_probs[i];
+            if (cumulative >= limit) {
+                keep = i + 1;
+                break;
+            }
+        }
+    }
+    if (m_config.min_p > 0.0f) {
+        // m_probs[0] 为未归一化的最大概率（=1）
+        const float floor = m_config.min_p * m_probs[0];
+        size_t above = 1;
+        while (above < keep && m_probs[above] >= floor) {
+            above++;
+        }
+        keep = above;
+    }
+
+    float kept_sum = 0.0f;
+    for (size_t i = 0; i < keep; ++i) {
+        kept_sum += m_probs[i];
+    }
+    double target = next_uniform() * kept_sum;
+    for (size_t i = 0; i < keep; ++i) {
+        target -= m_probs[i];
+        if (target < 0.0) {
+            return m_candidates[i].token;
+        }
+    }
+    return m_candidates[keep - 1].token;
+}
+
+int TokenSampler::sample_and_accept(float* logits)
+{
+    int token = sample(logits);
+    accept(token);
+    return token;
+}
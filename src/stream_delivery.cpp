@@ -0,0 +1,191 @@
+#include "pb_sdk/stream_delivery.h"
+
+#include <utility>
+
+namespace {
+
+/**
+ * @brief 仅包含单个文本增量、可与相邻 chunk 合并
+ */
+bool is_text_only(const ChatCompletionChunkObject& chunk) {
+    if (chunk.choices.size() != 1) {
+        return false;
+    }
+    const auto& choice = chunk.choices.front();
+    return choice.index == 0 && !choice.finish_reason && !choice.delta.role && choice.delta.content;
+}
+
+}  // namespace
+
+StreamDelivery::StreamDelivery(stream_cb_t callback, const StreamDeliveryConfig& config)
+    : m_callback(std::move(callback)), m_config(config), m_ring(config.ring_capacity)
+{
+    m_thread = std::thread([this] { delivery_loop(); });
+}
+
+StreamDelivery::~StreamDelivery()
+{
+    close();
+}
+
+stream_cb_t StreamDelivery::producer()
+{
+    return [this](const ChatCompletionChunkObject& chunk) { push(chunk); };
+}
+
+void StreamDelivery::wake()
+{
+    // 与投递线程写 m_sleeping 后检查队列配对，避免入队与进入等待交错时丢失唤醒
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cv.notify_one();
+    }
+}
+
+void StreamDelivery::push(const ChatCompletionChunkObject& chunk)
+{
+    if (m_closed) {
+        return;
+    }
+    m_events++;
+    Event event;
+    if (m_header_sent && is_text_only(chunk)) {
+        event.text = *chunk.choices.front().delta.content;
+        event.usage = chunk.usage;
+        event.metric = chunk.metric;
+        event.created = chunk.created;
+    } else {
+        event.chunk = std::make_unique<ChatCompletionChunkObject>(chunk);
+        m_header_sent = true;
+    }
+
+    // 溢出队列非空时继续排在它后面，保持顺序
+    if (!m_overflow_pending.load(std::memory_order_acquire) && m_ring.try_push(event)) {
+        wake();
+        return;
+    }
+    // 环满：不等待消费者，文本并入溢出队列的最后一个文本事件
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_overflowed++;
+    if (!event.chunk && !m_overflow.empty() && !m_overflow.back().chunk) {
+        Event& last = m_overflow.back();
+        last.text += event.text;
+        last.usage = event.usage;
+        last.metric = event.metric;
+        last.created = event.created;
+    } else {
+        m_overflow.push_back(std::move(event));
+    }
+    m_overflow_pending.store(true, std::memory_order_release);
+    m_cv.notify_one();
+}
+
+void StreamDelivery::close()
+{
+    if (m_closed) {
+        return;
+    }
+    m_closed = true;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_producer_done.store(true, std::memory_order_release);
+        m_cv.notify_one();
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+StreamDeliveryStats StreamDelivery::stats() const
+{
+    StreamDeliveryStats stats;
+    stats.events = m_events;
+    stats.delivered = m_delivered;
+    stats.overflowed = m_overflowed;
+    return stats;
+}
+
+void StreamDelivery::deliver_text(Event& pending)
+{
+    if (pending.text.empty()) {
+        return;
+    }
+    // id、model 等取自最近的完整 chunk，usage、metric 与 created 取自最后合并的增量
+    ChatCompletionChunkObject chunk = m_template;
+    chunk.usage = pending.usage;
+    chunk.metric = pending.metric;
+    chunk.created = pending.created;
+    chunk.choices.assign(1, ChatCompletionChunkChoice());
+    chunk.choices.front().index = 0;
+    chunk.choices.front().delta.content = std::move(pending.text);
+    pending.text.clear();
+    m_delivered++;
+    if (m_callback) {
+        m_callback(chunk);
+    }
+}
+
+void StreamDelivery::handle(Event& event, Event& pending)
+{
+    if (event.chunk) {
+        deliver_text(pending);
+        m_template = *event.chunk;
+        m_delivered++;
+        if (m_callback) {
+            m_callback(*event.chunk);
+        }
+        event.chunk.reset();
+    } else {
+        pending.text += event.text;
+        pending.usage = event.usage;
+        pending.metric = event.metric;
+        pending.created = event.created;
+    }
+}
+
+bool StreamDelivery::has_work() const
+{
+    return !m_ring.empty() || m_overflow_pending.load(std::memory_order_acquire) ||
+           m_producer_done.load(std::memory_order_acquire);
+}
+
+void StreamDelivery::delivery_loop()
+{
+    Event pending;
+    Event event;
+    while (true) {
+        // 先读结束标记再取空队列，保证结束前入队的事件都被处理
+        bool done = m_producer_done.load(std::memory_order_acquire);
+        // 回调期间积压在环中的连续文本合并为一次投递；没有积压时每个事件单独投递
+        while (m_ring.try_pop(event)) {
+            handle(event, pending);
+        }
+        if (m_overflow_pending.load(std::memory_order_acquire)) {
+            // 溢出队列非空期间生产端不再写环，先取完环中更早的事件，再整体取走溢出队列
+            while (m_ring.try_pop(event)) {
+                handle(event, pending);
+            }
+            std::deque<Event> overflow;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                overflow.swap(m_overflow);
+                m_overflow_pending.store(false, std::memory_order_release);
+            }
+            for (auto& item : overflow) {
+                handle(item, pending);
+            }
+            continue;
+        }
+        deliver_text(pending);
+        if (done) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_cv.wait(lock, [this] { return has_work(); });
+        m_sleeping.store(false, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,87 @@
+#include "pb_sdk/stream_latency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief 最近秩分位数：取第 ceil(q * n) 个值，样本较少时 p99 取到最大值而不是被低估
+ */
+double percentile(const std::vector<double>& sorted, double q) {
+    size_t rank = static_cast<size_t>(std::ceil(q * sorted.size()));
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+bool has_content(const ChatCompletionChunkObject& chunk) {
+    for (const auto& choice : chunk.choices) {
+        if (choice.delta.content && !choice.delta.content->empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+void StreamLatencyRecorder::start()
+{
+    m_start = clock::now();
+    m_last = m_start;
+    m_chunks = 0;
+    m_arrivals.clear();
+    m_started = true;
+}
+
+void StreamLatencyRecorder::on_chunk(const ChatCompletionChunkObject& chunk)
+{
+    m_last = clock::now();
+    m_chunks++;
+    if (has_content(chunk)) {
+        m_arrivals.push_back(m_last);
+    }
+}
+
+stream_cb_t StreamLatencyRecorder::wrap(stream_cb_t callback)
+{
+    return [this, callback = std::move(callback)](const ChatCompletionChunkObject& chunk) {
+        on_chunk(chunk);
+        if (callback) {
+            callback(chunk);
+        }
+    };
+}
+
+StreamLatencyReport StreamLatencyRecorder::report() const
+{
+    using ms = std::chrono::duration<double, std::milli>;
+    StreamLatencyReport report;
+    if (!m_started) {
+        // 没有请求发出时刻，到达时刻无法换算为延迟
+        return report;
+    }
+    report.chunks = m_chunks;
+    report.content_chunks = m_arrivals.size();
+    if (m_chunks > 0) {
+        report.total_ms = ms(m_last - m_start).count();
+    }
+    if (m_arrivals.empty()) {
+        return report;
+    }
+    report.ttft_ms = ms(m_arrivals.front() - m_start).count();
+    if (m_arrivals.size() < 2) {
+        return report;
+    }
+    std::vector<double> gaps;
+    gaps.reserve(m_arrivals.size() - 1);
+    for (size_t i = 1; i < m_arrivals.size(); ++i) {
+        gaps.push_back(ms(m_arrivals[i] - m_arrivals[i - 1]).count());
+    }
+    std::sort(gaps.begin(), gaps.end());
+    report.itl_p50_ms = percentile(gaps, 0.50);
+    report.itl_p90_ms = percentile(gaps, 0.90);
+    report.itl_p99_ms = percentile(gaps, 0.99);
+    report.itl_max_ms = gaps.back();
+    return report;
+}
@@ -0,0 +1,117 @@
+#include "pb_sdk/token_radix_tree.h"
+
+#include <algorithm>
+
+TokenRadixTree::TokenRadixTree()
+    : m_root(std::make_unique<Node>()), m_size(0)
+{
+}
+
+void TokenRadixTree::insert(const int* tokens, size_t count)
+{
+    Node* node = m_root.get();
+    size_t i = 0;
+    while (i < count) {
+        auto it = node->children.find(tokens[i]);
+        if (it == node->children.end()) {
+            auto leaf = std::make_unique<Node>();
+            leaf->edge.assign(tokens + i, tokens + count);
+            leaf->terminal = true;
+            node->children.emplace(tokens[i], std::move(leaf));
+            m_size++;
+            return;
+        }
+        Node* child = it->second.get();
+        const size_t limit = std::min(child->edge.size(), count - i);
+        size_t common = 0;
+        while (common < limit && child->edge[common] == tokens[i + common]) {
+            common++;
+        }
+        if (common < child->edge.size()) {
+            // 在公共部分处拆分边
+            auto mid = std::make_unique<Node>();
+            mid->edge.assign(child->edge.begin(), child->edge.begin() + common);
+            std::unique_ptr<Node> tail = std::move(it->second);
+            tail->edge.erase(tail->edge.begin(), tail->edge.begin() + common);
+            mid->children.emplace(tail->edge.front(), std::move(tail));
+            it->second = std::move(mid);
+            child = it->second.get();
+        }
+        node = child;
+        i += common;
+    }
+    if (!node->terminal && node != m_root.get()) {
+        node->terminal = true;
+        m_size++;
+    }
+}
+
+bool TokenRadixTree::erase_from(Node& node, const int* tokens, size_t count)
+{
+    auto it = node.children.find(tokens[0]);
+    if (it == node.children.end()) {
+        return false;
+    }
+    Node& child = *it->second;
+    if (child.edge.size() > count || !std::equal(child.edge.begin(), child.edge.end(), tokens)) {
+        return false;
+    }
+    const size_t rest = count - child.edge.size();
+    if (rest == 0) {
+        if (!child.terminal) {
+            return false;
+        }
+        child.terminal = false;
+    } else if (!erase_from(child, tokens + child.edge.size(), rest)) {
+        return false;
+    }
+
+    // 清理：无子节点的非终止节点删除，单子节点的非终止节点与子节点合并
+    if (!child.terminal && child.children.empty()) {
+        node.children.erase(it);
+    } else if (!child.terminal && child.children.size() == 1) {
+        std::unique_ptr<Node> grandchild = std::move(child.children.begin()->second);
+        grandchild->edge.insert(grandchild->edge.begin(), child.edge.begin(), child.edge.end());
+        it->second = std::move(grandchild);
+    }
+    return true;
+}
+
+bool TokenRadixTree::erase(const int* tokens, size_t count)
+{
+    if (count == 0 || !erase_from(*m_root, tokens, count)) {
+        return false;
+    }
+    m_size--;
+    return true;
+}
+
+size_t TokenRadixTree::longest_match(const int* tokens, size_t count) const
+{
+    const Node* node = m_root.get();
+    size_t depth = 0;
+    size_t best = 0;
+    while (depth < count) {
+        auto it = node->children.find(tokens[depth]);
+        if (it == node->children.end()) {
+            break;
+        }
+        const Node* child = it->second.get();
+        if (child->edge.size() > count - depth ||
+            !std::equal(child->edge.begin(), child->edge.end(), tokens + depth)) {
+            break;
+        }
+        depth += child->edge.size();
+        if (child->terminal) {
+            best = depth;
+        }
+        node = child;
+    }
+    return best;
+}
+
+void TokenRadixTree::clear()
+{
+    m_root = std::make_unique<Node>();
+    m_size = 0;
+}
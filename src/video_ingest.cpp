@@ -0,0 +1,235 @@
+#include "pb_sdk/video_ingest.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+
+#include "pb_sdk/cpu_affinity.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+double elapsed_ms(clock_type::time_point start) {
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+/**
+ * @brief 视频帧使用模型的 smart_resize 参数，像素上限取 config.max_pixels
+ */
+VlPreprocessParams video_params(const VideoIngestConfig& config) {
+    std::optional<VlPreprocessParams> params = vl_preprocess_params(config.model);
+    if (!params || params->mode != VlResizeMode::SMART_RESIZE) {
+        throw std::invalid_argument("VideoIngest: model " + std::to_string(config.model) +
+                                    " does not take smart-resized video input");
+    }
+    params->max_pixels = std::max(config.max_pixels, params->min_pixels);
+    return *params;
+}
+
+}  // namespace
+
+VideoIngest::VideoIngest(const VideoIngestConfig& config)
+    : m_config(config), m_preprocessor(video_params(config), 1)
+{
+    std::vector<int> cpus = m_config.cpus;
+    m_pool = std::make_unique<ThreadPool>(m_config.thread_nums, [cpus](int) { pin_current_thread(cpus); });
+}
+
+std::vector<double> VideoIngest::sample_timestamps(double duration_ms, float fps, int max_frames)
+{
+    std::vector<double> timestamps;
+    if (duration_ms <= 0.0 || fps <= 0.0f) {
+        return timestamps;
+    }
+    int count = std::max(1, static_cast<int>(std::floor(duration_ms * fps / 1000.0)));
+    double interval = 1000.0 / fps;
+    if ((max_frames > 0 && count > max_frames) || count * interval > duration_ms) {
+        // 超过上限，或视频短于一个采样区间：在全片均匀取点，保证采样点落在视频内
+        count = max_frames > 0 ? std::min(count, max_frames) : count;
+        interval = duration_ms / count;
+    }
+    timestamps.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        timestamps.push_back((i + 0.5) * interval);
+    }
+    return timestamps;
+}
+
+uint64_t VideoIngest::dhash(const cv::Mat& image)
+{
+    cv::Mat gray = image;
+    if (image.channels() == 3) {
+        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    }
+    cv::Mat small;
+    cv::resize(gray, small, cv::Size(9, 8), 0, 0, cv::INTER_AREA);
+    uint64_t hash = 0;
+    for (int y = 0; y < 8; ++y) {
+        const uint8_t* row = small.ptr<uint8_t>(y);
+        for (int x = 0; x < 8; ++x) {
+            hash = (hash << 1) | (row[x] > row[x + 1] ? 1u : 0u);
+        }
+    }
+    return hash;
+}
+
+std::vector<VideoFrame> VideoIngest::decode_segment(const std::string& path, const std::vector<double>& timestamps) const
+{
+    std::vector<VideoFrame> frames(timestamps.size());
+    cv::VideoCapture capture(path);
+    if (!capture.isOpened()) {
+        return frames;
+    }
+
+    cv::Mat bgr;
+    bool has_frame = false;
+    double pos_ms = 0.0;
+    for (size_t i = 0; i < timestamps.size(); ++i) {
+        const double ts = timestamps[i];
+        frames[i].timestamp_ms = ts;
+        bool ok = true;
+        if (has_frame && ts >= pos_ms && ts - pos_ms <= m_config.seek_gap_ms) {
+            // 间隔较小，顺序 grab 比 seek（回退到关键帧再解码）更快
+            bool advanced = false;
+            while (ok && pos_ms < ts) {
+                ok = capture.grab();
+                pos_ms = capture.get(cv::CAP_PROP_POS_MSEC);
+                advanced = true;
+            }
+            if (ok && advanced) {
+                ok = capture.retrieve(bgr);
+            }
+        } else {
+            capture.set(cv::CAP_PROP_POS_MSEC, ts);
+            ok = capture.read(bgr);
+            pos_ms = capture.get(cv::CAP_PROP_POS_MSEC);
+        }
+        has_frame = ok && !bgr.empty();
+        if (!has_frame) {
+            continue;
+        }
+
+        // 保持宽高比缩放到模型尺寸，preprocess_video 直接打包，不再二次缩放
+        const VlPreprocessParams& params = m_preprocessor.params();
+        const cv::Size size = VlPreprocessor::smart_resize(bgr.rows, bgr.cols, params.patch_size * params.merge_size,
+                                                           params.min_pixels, params.max_pixels);
+        cv::Mat resized = VlPreprocessor::resize(bgr, size);
+        cv::cvtColor(resized, frames[i].image, cv::COLOR_BGR2RGB);
+        cv::Mat gray;
+        cv::cvtColor(resized, gray, cv::COLOR_BGR2GRAY);
+        cv::resize(gray, frames[i].thumb, cv::Size(32, 32), 0, 0, cv::INTER_AREA);
+        frames[i].hash = dhash(frames[i].thumb);
+    }
+    return frames;
+}
+
+std::vector<VideoFrame> VideoIngest::prune_duplicates(std::vector<VideoFrame> frames, int hash_distance,
+                                                      double sad_threshold)
+{
+    std::vector<VideoFrame> kept;
+    kept.reserve(frames.size());
+    for (auto& frame : frames) {
+        if (frame.image.empty()) {
+            continue;
+        }
+        if (!kept.empty()) {
+            // 与上一保留帧比较，缓慢变化的画面累积到阈值后仍会保留
+            const VideoFrame& last = kept.back();
+            int distance = __builtin_popcountll(frame.hash ^ last.hash);
+            if (distance <= hash_distance) {
+                double sad = cv::norm(frame.thumb, last.thumb, cv::NORM_L1) / frame.thumb.total();
+                if (sad <= sad_threshold) {
+                    continue;
+                }
+            }
+        }
+        kept.push_back(std::move(frame));
+    }
+    return kept;
+}
+
+VideoIngestResult VideoIngest::ingest(const std::string& path)
+{
+    VideoIngestResult result;
+    double duration_ms = 0.0;
+    {
+        cv::VideoCapture probe(path);
+        if (!probe.isOpened()) {
+            std::cerr << "Error: Cannot open video " << path << std::endl;
+            return result;
+        }
+        double video_fps = probe.get(cv::CAP_PROP_FPS);
+        double frame_count = probe.get(cv::CAP_PROP_FRAME_COUNT);
+        if (video_fps > 0.0) {
+            duration_ms = frame_count / video_fps * 1000.0;
+        }
+    }
+
+    std::vector<double> timestamps = sample_timestamps(duration_ms, m_config.fps, m_config.max_frames);
+    result.stats.sampled = static_cast<int>(timestamps.size());
+    if (timestamps.empty()) {
+        return result;
+    }
+
+    // 每个线程负责一段连续时间点，段内可顺序 grab
+    auto start = clock_type::now();
+    size_t segments = std::min(m_pool->size(), timestamps.size());
+    std::vector<std::future<std::vector<VideoFrame>>> futures;
+    futures.reserve(segments);
+    for (size_t s = 0; s < segments; ++s) {
+        size_t begin = timestamps.size() * s / segments;
+        size_t end = timestamps.size() * (s + 1) / segments;
+        std::vector<double> segment(timestamps.begin() + begin, timestamps.begin() + end);
+        futures.push_back(m_pool->submit([this, path, segment] { return decode_segment(path, segment); }));
+    }
+    std::vector<VideoFrame> frames;
+    frames.reserve(timestamps.size());
+    for (auto& future : futures) {
+        for (auto& frame : future.get()) {
+            frames.push_back(std::move(frame));
+        }
+    }
+    result.stats.decode_ms = elapsed_ms(start);
+    result.stats.decoded = static_cast<int>(std::count_if(frames.begin(), frames.end(),
+                                                          [](const VideoFrame& f) { return !f.image.empty(); }));
+
+    start = clock_type::now();
+    result.frames = prune_duplicates(std::move(frames), m_config.hash_distance, m_config.sad_threshold);
+    result.stats.dedup_ms = elapsed_ms(start);
+    result.stats.kept = static_cast<int>(result.frames.size());
+    result.stats.dropped = result.stats.decoded - result.stats.kept;
+
+    if (result.frames.empty()) {
+        return result;
+    }
+    // 所有帧来自同一视频，smart_resize 尺寸一致；按模型的 [grid_t * grid_h * grid_w, C * T * P * P] 打包
+    std::vector<cv::Mat> images;
+    images.reserve(result.frames.size());
+    for (const auto& frame : result.frames) {
+        images.push_back(frame.image);
+    }
+    result.pixel = m_preprocessor.preprocess_video(images, true);
+    return result;
+}
+
+ContentPart VideoIngest::to_content_part(const std::string& path, const VideoIngestResult& result)
+{
+    ContentPart part;
+    part.type = "video";
+    part.video.push_back(path);
+    part.pixel_data = result.pixel.pixel_data;
+    return part;
+}
+
+double VideoIngest::estimate_ve_saved(const Metric& metric, const VideoIngestStats& stats)
+{
+    if (stats.kept <= 0) {
+        return 0.0;
+    }
+    return metric.ve_time / stats.kept * stats.dropped;
+}
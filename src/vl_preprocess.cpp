@@ -0,0 +1,305 @@
+#include "pb_sdk/vl_preprocess.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <stdexcept>
+#include <utility>
+
+#include "pb_sdk/cpu_affinity.h"
+#include "pb_sdk/fp16.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+double elapsed_ms(clock_type::time_point start) {
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+/**
+ * @brief 与 Python round 一致（银行家舍入）
+ */
+int round_even(double value) {
+    return static_cast<int>(std::nearbyint(value));
+}
+
+}  // namespace
+
+std::optional<VlPreprocessParams> vl_preprocess_params(int model)
+{
+    VlPreprocessParams params;
+    params.model = model;
+    switch (model) {
+    case QWEN_2_5VL_7B:
+    case QWEN_2_5VL_3B:
+    case QWEN_2_5VL_7B_DA04:
+    case QWEN_2_5OMNI_7B_DA04:
+        // 默认参数即 Qwen2.5-VL（OpenAI CLIP 均值方差，14x14 patch，2x2 合并，时间维 2）
+        return params;
+    case PALIGEMMA:
+    case PALIGEMMA_V1_1:
+        params.mode = VlResizeMode::FIXED;
+        params.image_size = 224;
+        params.mean = {0.5f, 0.5f, 0.5f};
+        params.stddev = {0.5f, 0.5f, 0.5f};
+        return params;
+    case INTERNVL3_8B:
+        params.mode = VlResizeMode::DYNAMIC_TILES;
+        params.image_size = 448;
+        params.mean = {0.485f, 0.456f, 0.406f};
+        params.stddev = {0.229f, 0.224f, 0.225f};
+        return params;
+    default:
+        return std::nullopt;
+    }
+}
+
+VlPreprocessor::VlPreprocessor(const VlPreprocessParams& params, int thread_nums, const std::vector<int>& cpus)
+    : m_params(params),
+      m_pool(std::make_unique<ThreadPool>(thread_nums, [cpus](int) { pin_current_thread(cpus); }))
+{
+    // /255 与 mean/std 在 u8 上只有 256 种取值，预先算好 float16 结果
+    for (int c = 0; c < 3; ++c) {
+        for (int v = 0; v < 256; ++v) {
+            m_lut[c][v] = float_to_fp16((v / 255.0f - m_params.mean[c]) / m_params.stddev[c]);
+        }
+    }
+}
+
+cv::Size VlPreprocessor::smart_resize(int height, int width, int factor, int min_pixels, int max_pixels)
+{
+    if (height <= 0 || width <= 0) {
+        throw std::invalid_argument("smart_resize: empty image");
+    }
+    int h_bar = std::max(factor, round_even(static_cast<double>(height) / factor) * factor);
+    int w_bar = std::max(factor, round_even(static_cast<double>(width) / factor) * factor);
+    if (static_cast<int64_t>(h_bar) * w_bar > max_pixels) {
+        double beta = std::sqrt(static_cast<double>(height) * width / max_pixels);
+        h_bar = std::max(factor, static_cast<int>(std::floor(height / beta / factor)) * factor);
+        w_bar = std::max(factor, static_cast<int>(std::floor(width / beta / factor)) * factor);
+    } else if (static_cast<int64_t>(h_bar) * w_bar < min_pixels) {
+        double beta = std::sqrt(static_cast<double>(min_pixels) / (static_cast<double>(height) * width));
+        h_bar = static_cast<int>(std::ceil(height * beta / factor)) * factor;
+        w_bar = static_cast<int>(std::ceil(width * beta / factor)) * factor;
+    }
+    return cv::Size(w_bar, h_bar);
+}
+
+cv::Mat VlPreprocessor::resize(const cv::Mat& src, const cv::Size& size)
+{
+    if (src.size() == size) {
+        return src;
+    }
+    cv::Mat reduced = src;
+    const cv::Size mid(std::min(src.cols, 2 * size.width), std::min(src.rows, 2 * size.height));
+    if (mid != src.size()) {
+        cv::resize(src, reduced, mid, 0, 0, cv::INTER_AREA);
+    }
+    cv::Mat out;
+    cv::resize(reduced, out, size, 0, 0, cv::INTER_CUBIC);
+    return out;
+}
+
+void VlPreprocessor::pack_patches(const std::vector<cv::Mat>& frames, bool is_rgb, VlPixelData& out) const
+{
+    const int ps = m_params.patch_size;
+    const int ms = m_params.merge_size;
+    const int tps = m_params.temporal_patch_size;
+    const int height = frames.front().rows;
+    const int width = frames.front().cols;
+    out.grid_t = static_cast<int>(frames.size()) / tps;
+    out.grid_h = height / ps;
+    out.grid_w = width / ps;
+    const int64_t rows = static_cast<int64_t>(out.grid_t) * out.grid_h * out.grid_w;
+    const int64_t row_len = 3LL * tps * ps * ps;
+    out.shape = {rows, row_len};
+    out.pixel_data.resize(static_cast<size_t>(rows * row_len));
+
+    // 与 HF Qwen2VLImageProcessor 一致的顺序:
+    // [grid_t, grid_h/m, grid_w/m, m, m] 个 patch，每个 patch 内为 [C, T, P, P]
+    uint16_t* dst = out.pixel_data.data();
+    for (int t = 0; t < out.grid_t; ++t) {
+        for (int bh = 0; bh < out.grid_h / ms; ++bh) {
+            for (int bw = 0; bw < out.grid_w / ms; ++bw) {
+                for (int mh = 0; mh < ms; ++mh) {
+                    for (int mw = 0; mw < ms; ++mw) {
+                        const int py0 = (bh * ms + mh) * ps;
+                        const int px0 = (bw * ms + mw) * ps;
+                        for (int c = 0; c < 3; ++c) {
+                            const uint16_t* lut = m_lut[c].data();
+                            const int sc = is_rgb ? c : 2 - c;
+                            for (int tt = 0; tt < tps; ++tt) {
+                                const cv::Mat& frame = frames[t * tps + tt];
+                                for (int y = 0; y < ps; ++y) {
+                                    const uint8_t* src = frame.ptr<uint8_t>(py0 + y) + px0 * 3 + sc;
+                                    for (int x = 0; x < ps; ++x) {
+                                        *dst++ = lut[src[3 * x]];
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void VlPreprocessor::pack_chw(const std::vector<cv::Mat>& images, VlPixelData& out) const
+{
+    const int height = images.front().rows;
+    const int width = images.front().cols;
+    const size_t plane = static_cast<size_t>(height) * width;
+    out.shape = {static_cast<int64_t>(images.size()), 3, height, width};
+    out.pixel_data.resize(images.size() * 3 * plane);
+    for (size_t n = 0; n < images.size(); ++n) {
+        uint16_t* r = out.pixel_data.data() + n * 3 * plane;
+        uint16_t* g = r + plane;
+        uint16_t* b = g + plane;
+        for (int y = 0; y < height; ++y) {
+            const uint8_t* src = images[n].ptr<uint8_t>(y);
+            const size_t offset = static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                r[offset + x] = m_lut[0][src[3 * x + 2]];
+                g[offset + x] = m_lut[1][src[3 * x + 1]];
+                b[offset + x] = m_lut[2][src[3 * x]];
+            }
+        }
+    }
+}
+
+std::vector<cv::Mat> VlPreprocessor::dynamic_tiles(const cv::Mat& bgr, cv::Size& resized) const
+{
+    const int size = m_params.image_size;
+    const double aspect = static_cast<double>(bgr.cols) / bgr.rows;
+
+    // 候选网格 (i, j)，按块数升序，与 InternVL dynamic_preprocess 的选择规则一致
+    std::vector<std::pair<int, int>> ratios;
+    for (int n = m_params.min_tiles; n <= m_params.max_tiles; ++n) {
+        for (int i = 1; i <= n; ++i) {
+            for (int j = 1; j <= n; ++j) {
+                int blocks = i * j;
+                if (blocks >= m_params.min_tiles && blocks <= m_params.max_tiles &&
+                    std::find(ratios.begin(), ratios.end(), std::make_pair(i, j)) == ratios.end()) {
+                    ratios.emplace_back(i, j);
+                }
+            }
+        }
+    }
+    std::stable_sort(ratios.begin(), ratios.end(), [](const auto& a, const auto& b) {
+        return a.first * a.second < b.first * b.second;
+    });
+
+    std::pair<int, int> best{1, 1};
+    double best_diff = 1e30;
+    const double area = static_cast<double>(bgr.cols) * bgr.rows;
+    for (const auto& ratio : ratios) {
+        double diff = std::abs(aspect - static_cast<double>(ratio.first) / ratio.second);
+        if (diff < best_diff) {
+            best_diff = diff;
+            best = ratio;
+        } else if (diff == best_diff && area > 0.5 * size * size * ratio.first * ratio.second) {
+            best = ratio;
+        }
+    }
+
+    resized = cv::Size(size * best.first, size * best.second);
+    cv::Mat full = resize(bgr, resized);
+    std::vector<cv::Mat> tiles;
+    for (int k = 0; k < best.first * best.second; ++k) {
+        cv::Rect box((k % best.first) * size, (k / best.first) * size, size, size);
+        tiles.push_back(full(box));
+    }
+    if (m_params.use_thumbnail && tiles.size() != 1) {
+        tiles.push_back(resize(bgr, cv::Size(size, size)));
+    }
+    return tiles;
+}
+
+VlPixelData VlPreprocessor::preprocess(const cv::Mat& bgr) const
+{
+    if (bgr.empty() || bgr.type() != CV_8UC3) {
+        throw std::invalid_argument("VlPreprocessor: expect non-empty CV_8UC3 image");
+    }
+    auto start = clock_type::now();
+    VlPixelData out;
+    switch (m_params.mode) {
+    case VlResizeMode::SMART_RESIZE: {
+        const int factor = m_params.patch_size * m_params.merge_size;
+        out.resized = smart_resize(bgr.rows, bgr.cols, factor, m_params.min_pixels, m_params.max_pixels);
+        cv::Mat resized = resize(bgr, out.resized);
+        // 单张图像在时间维上重复
+        pack_patches(std::vector<cv::Mat>(m_params.temporal_patch_size, resized), false, out);
+        break;
+    }
+    case VlResizeMode::FIXED: {
+        out.resized = cv::Size(m_params.image_size, m_params.image_size);
+        pack_chw({resize(bgr, out.resized)}, out);
+        break;
+    }
+    case VlResizeMode::DYNAMIC_TILES:
+        pack_chw(dynamic_tiles(bgr, out.resized), out);
+        break;
+    }
+    out.preprocess_ms = elapsed_ms(start);
+    return out;
+}
+
+VlPixelData VlPreprocessor::preprocess_video(const std::vector<cv::Mat>& frames, bool is_rgb) const
+{
+    if (m_params.mode != VlResizeMode::SMART_RESIZE) {
+        throw std::invalid_argument("VlPreprocessor: video input is only supported by smart-resize models");
+    }
+    if (frames.empty() || frames.front().type() != CV_8UC3) {
+        throw std::invalid_argument("VlPreprocessor: expect non-empty CV_8UC3 frames");
+    }
+    auto start = clock_type::now();
+    VlPixelData out;
+    const int factor = m_params.patch_size * m_params.merge_size;
+    out.resized = smart_resize(frames.front().rows, frames.front().cols, factor, m_params.min_pixels, m_params.max_pixels);
+    std::vector<cv::Mat> resized(frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        resized[i] = resize(frames[i], out.resized);
+    }
+    while (resized.size() % m_params.temporal_patch_size != 0) {
+        resized.push_back(resized.back());
+    }
+    pack_patches(resized, is_rgb, out);
+    out.preprocess_ms = elapsed_ms(start);
+    return out;
+}
+
+std::vector<VlPixelData> VlPreprocessor::preprocess_batch(const std::vector<cv::Mat>& images)
+{
+    std::vector<std::future<VlPixelData>> futures;
+    futures.reserve(images.size());
+    for (const auto& image : images) {
+        futures.push_back(m_pool->submit([this, &image] { return preprocess(image); }));
+    }
+    std::vector<VlPixelData> results;
+    results.reserve(images.size());
+    for (auto& future : futures) {
+        results.push_back(future.get());
+    }
+    return results;
+}
+
+ContentPart VlPreprocessor::to_content_part(const std::string& url, const VlPixelData& data)
+{
+    ContentPart part;
+    part.type = "image_url";
+    part.image_url.url = url;
+    part.pixel_data = data.pixel_data;
+    return part;
+}
+
+double VlPreprocessor::total_preprocess_ms(const std::vector<VlPixelData>& results)
+{
+    double total = 0.0;
+    for (const auto& result : results) {
+        total += result.preprocess_ms;
+    }
+    return total;
+}
@@ -0,0 +1,92 @@
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+#include "pb_sdk/cpu_affinity.h"
+#include "test_util.h"
+
+namespace {
+
+void test_parse_cpu_list() {
+    CHECK((parse_cpu_list("4-5, 7,4") == std::vector<int>{4, 5, 7}));
+    CHECK(parse_cpu_list("").empty());
+    bool thrown = false;
+    try {
+        parse_cpu_list("3-1");
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+void test_load_affinity_config() {
+    const std::string path = "affinity_test.json";
+    {
+        std::ofstream file(path);
+        file << R"({"affinity": {"decode": "0-1", "preprocess": "2", "buffer_node": 0}})";
+    }
+    AffinityConfig config = load_affinity_config(path);
+    std::remove(path.c_str());
+    CHECK((config.decode_cpus == std::vector<int>{0, 1}));
+    CHECK((config.preprocess_cpus == std::vector<int>{2}));
+    CHECK(config.postprocess_cpus.empty());
+    CHECK(config.buffer_node == 0);
+    CHECK(load_affinity_config("does_not_exist.json").buffer_node == -1);
+}
+
+void test_pin_rejects_out_of_range() {
+    CHECK(pin_current_thread({}));
+    CHECK(!pin_current_thread({CPU_SETSIZE}));
+    CHECK(!pin_current_thread({-1}));
+}
+
+void test_node_buffer_pool() {
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    NodeBufferPool pool(page + 1, -1);
+    CHECK(pool.block_size() == page * 2);
+
+    void* first = nullptr;
+    {
+        std::shared_ptr<void> buffer = pool.acquire();
+        CHECK(buffer != nullptr);
+        CHECK(reinterpret_cast<uintptr_t>(buffer.get()) % page == 0);
+        first = buffer.get();
+    }
+    // 归还后复用同一块缓冲区
+    std::shared_ptr<void> reused = pool.acquire();
+    CHECK(reused.get() == first);
+    std::shared_ptr<void> other = pool.acquire();
+    CHECK(other.get() != first);
+}
+
+void test_bind_to_node() {
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    std::vector<uint8_t> small(page / 2);
+    CHECK(bind_to_node(small.data(), small.size(), -1));
+    // 不含整页的范围无法绑定，必须返回失败而不是静默成功
+    CHECK(!bind_to_node(small.data(), small.size(), 0));
+
+    struct stat st;
+    if (stat("/sys/devices/system/node/node0", &st) == 0) {
+        NodeBufferPool pool(page * 4, 0);
+        std::shared_ptr<void> buffer = pool.acquire();
+        CHECK(bind_to_node(buffer.get(), pool.block_size(), 0));
+    }
+}
+
+}  // namespace
+
+int main() {
+    test_parse_cpu_list();
+    test_load_affinity_config();
+    test_pin_rejects_out_of_range();
+    test_node_buffer_pool();
+    test_bind_to_node();
+    return test_result("affinity_test");
+}
@@ -0,0 +1,113 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "pb_sdk/audio_features.h"
+#include "test_util.h"
+
+namespace {
+
+constexpr int kRate = 16000;
+
+float fp16_to_float(uint16_t h) {
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    const int exponent = (h >> 10) & 0x1f;
+    const uint32_t mantissa = h & 0x3ff;
+    if (exponent == 0) {
+        const float value = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -value : value;
+    }
+    const uint32_t bits = sign | static_cast<uint32_t>(exponent - 15 + 127) << 23 | mantissa << 13;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::vector<float> sine(float hz, int samples) {
+    const double pi = std::acos(-1.0);
+    std::vector<float> pcm(samples);
+    for (int i = 0; i < samples; ++i) {
+        pcm[i] = static_cast<float>(0.5 * std::sin(2.0 * pi * hz * i / kRate));
+    }
+    return pcm;
+}
+
+/**
+ * @brief 中间帧能量最大的梅尔通道
+ */
+int peak_mel(const StreamingAudioFeatures& features) {
+    const std::vector<uint16_t> packed = features.packed_fp16();
+    const size_t frames = features.num_frames();
+    const size_t mid = frames / 2;
+    const int n_mels = static_cast<int>(packed.size() / frames);
+    int best = 0;
+    for (int m = 1; m < n_mels; ++m) {
+        if (fp16_to_float(packed[m * frames + mid]) > fp16_to_float(packed[best * frames + mid])) {
+            best = m;
+        }
+    }
+    return best;
+}
+
+void test_streaming_matches_one_shot() {
+    const std::vector<float> pcm = sine(440.0f, kRate);
+
+    StreamingAudioFeatures one_shot;
+    one_shot.push_pcm(pcm.data(), pcm.size(), 1, kRate);
+    one_shot.finish();
+
+    // 不整齐的分块，覆盖帧跨块与头部采样丢弃
+    StreamingAudioFeatures streaming;
+    int incremental = 0;
+    for (size_t pos = 0; pos < pcm.size(); pos += 333) {
+        const size_t n = std::min<size_t>(333, pcm.size() - pos);
+        incremental += streaming.push_pcm(pcm.data() + pos, n, 1, kRate);
+    }
+    incremental += streaming.finish();
+
+    // 与 Whisper 一致：帧数为 N / hop
+    CHECK(one_shot.num_frames() == pcm.size() / 160);
+    CHECK(streaming.num_frames() == one_shot.num_frames());
+    CHECK(static_cast<size_t>(incremental) == streaming.num_frames());
+    CHECK(streaming.packed_fp16() == one_shot.packed_fp16());
+}
+
+void test_peak_follows_frequency() {
+    AudioFeatureConfig config;
+    int previous = -1;
+    for (float hz : {250.0f, 1000.0f, 4000.0f}) {
+        const std::vector<float> pcm = sine(hz, kRate / 2);
+        StreamingAudioFeatures features(config);
+        features.push_pcm(pcm.data(), pcm.size(), 1, kRate);
+        features.finish();
+        const int peak = peak_mel(features);
+        CHECK(peak > previous);
+        previous = peak;
+    }
+}
+
+void test_stereo_is_averaged() {
+    const std::vector<float> mono = sine(1000.0f, kRate / 4);
+    std::vector<float> stereo(mono.size() * 2);
+    for (size_t i = 0; i < mono.size(); ++i) {
+        stereo[i * 2] = mono[i];
+        stereo[i * 2 + 1] = mono[i];
+    }
+    StreamingAudioFeatures a;
+    StreamingAudioFeatures b;
+    a.push_pcm(mono.data(), mono.size(), 1, kRate);
+    b.push_pcm(stereo.data(), mono.size(), 2, kRate);
+    a.finish();
+    b.finish();
+    CHECK(a.packed_fp16() == b.packed_fp16());
+}
+
+}  // namespace
+
+int main() {
+    test_streaming_matches_one_shot();
+    test_peak_follows_frequency();
+    test_stereo_is_averaged();
+    return test_result("audio_features_test");
+}
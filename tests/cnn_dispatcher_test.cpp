@@ -0,0 +1,256 @@
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pb_sdk/cnn_dispatcher.h"
+#include "test_util.h"
+
+namespace {
+
+CnnChatCompletions make_request(const std::string& name) {
+    CnnChatCompletions request;
+    request.case_name = name;
+    return request;
+}
+
+/**
+ * @brief 按请求 ID 收集回调结果
+ */
+class Results
+{
+public:
+    cnn_result_cb_t callback() {
+        return [this](const CnnRequestResult& result) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_results[result.id].push_back(result);
+            m_cv.notify_all();
+        };
+    }
+
+    bool wait_for(uint64_t id) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_cv.wait_for(lock, std::chrono::seconds(2), [&] { return m_results.count(id) > 0; });
+    }
+
+    // 每个请求只应回调一次
+    size_t count(uint64_t id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_results.find(id);
+        return it == m_results.end() ? 0 : it->second.size();
+    }
+
+    CnnRequestResult get(uint64_t id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_results.at(id).front();
+    }
+
+private:
+    std::mutex                                          m_mutex;
+    std::condition_variable                             m_cv;
+    std::map<uint64_t, std::vector<CnnRequestResult>>   m_results;
+};
+
+/**
+ * @brief 阻塞执行函数，直到 open() 后才返回，模拟 NPU 上正在执行的请求
+ */
+class Gate
+{
+public:
+    cnn_executor_t executor() {
+        return [this](const CnnChatCompletions& request, CnnChatCompletions& response) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_running.push_back(request.case_name);
+            m_cv.notify_all();
+            m_cv.wait(lock, [this] { return m_open; });
+            response = request;
+            return static_cast<int>(PBNN_SUCCESS);
+        };
+    }
+
+    bool wait_running(const std::string& name) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_cv.wait_for(lock, std::chrono::seconds(2), [&] {
+            return !m_running.empty() && m_running.back() == name;
+        });
+    }
+
+    void open() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_open = true;
+        m_cv.notify_all();
+    }
+
+    std::vector<std::string> running() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_running;
+    }
+
+private:
+    std::mutex                  m_mutex;
+    std::condition_variable     m_cv;
+    std::vector<std::string>    m_running;
+    bool                        m_open = false;
+};
+
+void test_submit_before_init_is_rejected() {
+    std::vector<CnnRequestResult> results;
+    {
+        CnnDispatcher dispatcher;
+        uint64_t id = dispatcher.submit(CnnChatCompletions(), std::chrono::milliseconds(100),
+                                        [&](const CnnRequestResult& result) { results.push_back(result); });
+        // 没有调度线程时在提交线程立即回调，而不是留在队列中永远不完成
+        CHECK(results.size() == 1);
+        CHECK(results[0].id == id);
+        CHECK(results[0].status == PBNN_INIT_FAILED);
+        GoodputStats stats = dispatcher.stats();
+        CHECK(stats.submitted == 1);
+        CHECK(stats.failed == 1);
+    }
+    CHECK(results.size() == 1);
+}
+
+void test_submit_after_failed_init_is_rejected() {
+    std::vector<CnnRequestResult> results;
+    CnnDispatcher dispatcher;
+    CHECK(dispatcher.init(cnn_executor_t()) == PBNN_INVALID_ARGUMENT);
+    dispatcher.submit(CnnChatCompletions(), std::chrono::milliseconds(100),
+                      [&](const CnnRequestResult& result) { results.push_back(result); });
+    CHECK(results.size() == 1);
+    CHECK(!results.empty() && results[0].status == PBNN_INIT_FAILED);
+}
+
+void test_completed_in_deadline() {
+    Results results;
+    CnnDispatcher dispatcher;
+    CHECK(dispatcher.init([](const CnnChatCompletions& request, CnnChatCompletions& response) {
+        response = request;
+        return static_cast<int>(PBNN_SUCCESS);
+    }) == PBNN_SUCCESS);
+    CHECK(dispatcher.init([](const CnnChatCompletions&, CnnChatCompletions&) {
+        return static_cast<int>(PBNN_SUCCESS);
+    }) == PBNN_INVALID_ARGUMENT);
+
+    uint64_t id = dispatcher.submit(make_request("ok"), std::chrono::seconds(5), results.callback());
+    CHECK(results.wait_for(id));
+    CnnRequestResult result = results.get(id);
+    CHECK(result.status == PBNN_SUCCESS);
+    CHECK(result.response.case_name == "ok");
+    CHECK(result.latency_ms >= 0.0);
+
+    GoodputStats stats = dispatcher.stats();
+    CHECK(stats.submitted == 1);
+    CHECK(stats.completed_in_deadline == 1);
+    CHECK(stats.completed_late == 0);
+}
+
+void test_expire_and_cancel() {
+    Results results;
+    Gate gate;
+    uint64_t running = 0;
+    uint64_t expiring = 0;
+    uint64_t queued = 0;
+    {
+        CnnDispatcher dispatcher;
+        CHECK(dispatcher.init(gate.executor()) == PBNN_SUCCESS);
+
+        // running 占住调度线程，后续请求留在队列中
+        running = dispatcher.submit(make_request("running"), std::chrono::seconds(5), results.callback());
+        CHECK(gate.wait_running("running"));
+        expiring = dispatcher.submit(make_request("expiring"), std::chrono::milliseconds(10), results.callback());
+        queued = dispatcher.submit(make_request("queued"), std::chrono::seconds(5), results.callback());
+
+        // 排队中的请求取消后在 cancel 调用线程立即回调
+        CHECK(dispatcher.cancel(queued));
+        CHECK(results.count(queued) == 1);
+        CHECK(results.get(queued).status == PBNN_CANCELLED);
+        CHECK(!dispatcher.cancel(queued));
+
+        // 已下发的请求只做标记，执行完成后以 PBNN_CANCELLED 回调并丢弃结果
+        CHECK(dispatcher.cancel(running));
+        CHECK(results.count(running) == 0);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        gate.open();
+        CHECK(results.wait_for(running));
+        CHECK(results.wait_for(expiring));
+
+        CnnRequestResult cancelled = results.get(running);
+        CHECK(cancelled.status == PBNN_CANCELLED);
+        CHECK(cancelled.response.case_name.empty());
+        CHECK(results.get(expiring).status == PBNN_DEADLINE_EXCEEDED);
+
+        GoodputStats stats = dispatcher.stats();
+        CHECK(stats.submitted == 3);
+        CHECK(stats.cancelled == 2);
+        CHECK(stats.expired == 1);
+        CHECK(stats.completed_in_deadline == 0);
+        CHECK(stats.failed == 0);
+        CHECK(!dispatcher.cancel(running));
+    }
+    // 过期请求在下发前丢弃，从未进入执行函数
+    CHECK(gate.running() == std::vector<std::string>{"running"});
+    CHECK(results.count(running) == 1);
+    CHECK(results.count(expiring) == 1);
+    CHECK(results.count(queued) == 1);
+}
+
+void test_completed_late() {
+    Results results;
+    CnnDispatcher dispatcher;
+    CHECK(dispatcher.init([](const CnnChatCompletions& request, CnnChatCompletions& response) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        response = request;
+        return static_cast<int>(PBNN_SUCCESS);
+    }) == PBNN_SUCCESS);
+
+    uint64_t id = dispatcher.submit(make_request("late"), std::chrono::milliseconds(10), results.callback());
+    CHECK(results.wait_for(id));
+    CHECK(results.get(id).status == PBNN_DEADLINE_EXCEEDED);
+    CHECK(results.get(id).latency_ms >= 10.0);
+
+    GoodputStats stats = dispatcher.stats();
+    CHECK(stats.completed_late == 1);
+    CHECK(stats.expired == 0);
+}
+
+void test_executor_failure() {
+    Results results;
+    CnnDispatcher dispatcher;
+    CHECK(dispatcher.init([](const CnnChatCompletions& request, CnnChatCompletions& response) {
+        if (request.case_name == "throw") {
+            throw std::runtime_error("npu error");
+        }
+        response = request;
+        return static_cast<int>(PBNN_TIMEOUT);
+    }) == PBNN_SUCCESS);
+
+    uint64_t failed = dispatcher.submit(make_request("fail"), std::chrono::seconds(5), results.callback());
+    uint64_t thrown = dispatcher.submit(make_request("throw"), std::chrono::seconds(5), results.callback());
+    CHECK(results.wait_for(failed));
+    CHECK(results.wait_for(thrown));
+    // 执行函数的 PBNN 错误码原样返回，异常转为 PBNN_EXECUTE_FAILED，失败时不返回部分结果
+    CHECK(results.get(failed).status == PBNN_TIMEOUT);
+    CHECK(results.get(failed).response.case_name.empty());
+    CHECK(results.get(thrown).status == PBNN_EXECUTE_FAILED);
+
+    GoodputStats stats = dispatcher.stats();
+    CHECK(stats.failed == 2);
+    CHECK(stats.completed_in_deadline == 0);
+}
+
+}  // namespace
+
+int main() {
+    test_submit_before_init_is_rejected();
+    test_submit_after_failed_init_is_rejected();
+    test_completed_in_deadline();
+    test_expire_and_cancel();
+    test_completed_late();
+    test_executor_failure();
+    return test_result("cnn_dispatcher_test");
+}
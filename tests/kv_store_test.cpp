@@ -0,0 +1,198 @@
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "pb_sdk/kv_store.h"
+#include "test_util.h"
+
+namespace {
+
+std::string make_temp_dir() {
+    char pattern[] = "/tmp/kv_store_test.XXXXXX";
+    const char* dir = ::mkdtemp(pattern);
+    return dir != nullptr ? dir : "";
+}
+
+PrefixCache make_prefix(const std::vector<int>& token_ids, size_t layers, size_t per_layer, uint16_t seed) {
+    PrefixCache cache;
+    cache.token_ids = token_ids;
+    cache.k_cache.resize(layers);
+    cache.v_cache.resize(layers);
+    for (size_t layer = 0; layer < layers; ++layer) {
+        for (size_t i = 0; i < per_layer; ++i) {
+            cache.k_cache[layer].push_back(static_cast<uint16_t>(seed + layer * 1000 + i));
+            cache.v_cache[layer].push_back(static_cast<uint16_t>(seed + layer * 1000 + i + 500));
+        }
+    }
+    return cache;
+}
+
+bool same_prefix(const PrefixCache& a, const PrefixCache& b) {
+    return a.token_ids == b.token_ids && a.k_cache == b.k_cache && a.v_cache == b.v_cache;
+}
+
+void test_file_round_trip(const std::string& dir) {
+    PrefixCache cache = make_prefix({1, 2, 3, 4, 5}, 3, 700, 7);
+    const std::string path = dir + "/round_trip.bin";
+    CHECK(KvPrefixStore::write_file(path, cache));
+    auto mapped = MappedPrefixCache::open(path);
+    CHECK(mapped != nullptr);
+    if (mapped) {
+        CHECK(mapped->num_layers() == 3);
+        CHECK(mapped->num_tokens() == 5);
+        CHECK(mapped->header().prefix_hash == KvPrefixStore::prefix_hash(cache.token_ids.data(), 5));
+        // 各层数据段按页对齐
+        CHECK(reinterpret_cast<uintptr_t>(mapped->k_data(1)) % kKvFileAlignment == 0);
+        CHECK(same_prefix(mapped->to_prefix_cache(), cache));
+    }
+}
+
+void test_corrupt_header_is_rejected(const std::string& dir) {
+    PrefixCache cache = make_prefix({9, 8, 7}, 2, 16, 1);
+    const std::string path = dir + "/corrupt.bin";
+    CHECK(KvPrefixStore::write_file(path, cache));
+
+    // num_tokens 乘以 sizeof(int32_t) 后回绕到很小的值，未做溢出检查时会通过范围校验
+    KvFileHeader header;
+    int fd = ::open(path.c_str(), O_RDWR);
+    CHECK(fd >= 0);
+    CHECK(::pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)));
+    header.num_tokens = (UINT64_MAX / sizeof(int32_t)) + 2;
+    CHECK(::pwrite(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)));
+    ::close(fd);
+    CHECK(MappedPrefixCache::open(path) == nullptr);
+
+    // 截断的文件与 file_size 不符
+    CHECK(KvPrefixStore::write_file(path, cache));
+    CHECK(::truncate(path.c_str(), sizeof(KvFileHeader) + 8) == 0);
+    CHECK(MappedPrefixCache::open(path) == nullptr);
+    ::unlink(path.c_str());
+}
+
+void test_put_get_and_restart(const std::string& dir) {
+    PrefixCache shorter = make_prefix({10, 11, 12}, 2, 64, 3);
+    PrefixCache longer = make_prefix({10, 11, 12, 13, 14, 15}, 2, 128, 5);
+    {
+        KvPrefixStore store(dir, 1 << 20, 64 << 20);
+        CHECK(store.put(shorter));
+        CHECK(store.put(longer));
+        auto hit = store.get(longer.token_ids);
+        CHECK(hit != nullptr && same_prefix(*hit, longer));
+        CHECK(store.get({10, 11}) == nullptr);
+
+        auto match = store.match_longest({10, 11, 12, 13, 99});
+        CHECK(match != nullptr && match->token_ids == shorter.token_ids);
+        KvStoreStats stats = store.stats();
+        CHECK(stats.ram_hits == 2);
+        CHECK(stats.misses == 1);
+        CHECK(stats.reused_tokens == 3);
+    }
+
+    // 新实例只从磁盘重建索引，命中走磁盘层后提升到内存层
+    KvPrefixStore store(dir, 1 << 20, 64 << 20);
+    KvStoreStats stats = store.stats();
+    CHECK(stats.disk_entries == 2);
+    CHECK(stats.ram_entries == 0);
+    auto match = store.match_longest({10, 11, 12, 13, 14, 15, 16});
+    CHECK(match != nullptr && same_prefix(*match, longer));
+    CHECK(store.get(longer.token_ids) != nullptr);
+    stats = store.stats();
+    CHECK(stats.disk_hits == 1);
+    CHECK(stats.ram_hits == 1);
+    CHECK(stats.ram_entries == 1);
+}
+
+void test_ram_eviction_falls_back_to_disk(const std::string& dir) {
+    PrefixCache a = make_prefix({20, 21}, 1, 1024, 1);
+    PrefixCache b = make_prefix({30, 31}, 1, 1024, 2);
+    // 内存层只够放一个前缀
+    KvPrefixStore store(dir, 5000, 64 << 20);
+    CHECK(store.put(a));
+    CHECK(store.put(b));
+    KvStoreStats stats = store.stats();
+    CHECK(stats.ram_entries == 1);
+    CHECK(stats.ram_evictions == 1);
+
+    auto hit = store.get(a.token_ids);
+    CHECK(hit != nullptr && same_prefix(*hit, a));
+    CHECK(store.stats().disk_hits == 1);
+}
+
+void test_overwrite_updates_index(const std::string& dir) {
+    PrefixCache first = make_prefix({40, 41, 42}, 1, 32, 1);
+    PrefixCache second = make_prefix({40, 41, 42}, 1, 32, 9);
+    {
+        KvPrefixStore store(dir, 1 << 20, 64 << 20);
+        CHECK(store.put(first));
+        CHECK(store.put(second));
+        CHECK(store.stats().disk_entries == 1);
+        auto hit = store.get(first.token_ids);
+        CHECK(hit != nullptr && same_prefix(*hit, second));
+    }
+    KvPrefixStore store(dir, 1 << 20, 64 << 20);
+    auto hit = store.get(first.token_ids);
+    CHECK(hit != nullptr && same_prefix(*hit, second));
+}
+
+/**
+ * @brief 返回一个已退出并被回收的进程号
+ */
+pid_t exited_pid() {
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        ::_exit(0);
+    }
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    return pid;
+}
+
+bool file_exists(const std::string& path) {
+    return ::access(path.c_str(), F_OK) == 0;
+}
+
+void test_stale_tmp_removed_on_start(const std::string& dir) {
+    PrefixCache cache = make_prefix({50, 51, 52}, 1, 32, 4);
+    std::string stale;
+    std::string live;
+    {
+        KvPrefixStore store(dir, 1 << 20, 64 << 20);
+        CHECK(store.put(cache));
+        // 模拟 rename 之前崩溃的写入者，以及仍在写入的另一个进程
+        stale = dir + "/00000000deadbeef.pbkv.tmp." + std::to_string(exited_pid()) + ".0";
+        live = dir + "/00000000feedface.pbkv.tmp." + std::to_string(::getppid()) + ".0";
+        CHECK(KvPrefixStore::write_file(stale, cache));
+        CHECK(KvPrefixStore::write_file(live, cache));
+    }
+    KvPrefixStore store(dir, 1 << 20, 64 << 20);
+    CHECK(!file_exists(stale));
+    CHECK(file_exists(live));
+    CHECK(store.stats().disk_entries == 1);
+    CHECK(store.get(cache.token_ids) != nullptr);
+}
+
+void remove_dir(const std::string& dir) {
+    std::string command = "rm -rf '" + dir + "'";
+    CHECK(std::system(command.c_str()) == 0);
+}
+
+}  // namespace
+
+int main() {
+    const std::string root = make_temp_dir();
+    CHECK(!root.empty());
+    test_file_round_trip(root);
+    test_corrupt_header_is_rejected(root);
+    test_put_get_and_restart(root + "/restart");
+    test_ram_eviction_falls_back_to_disk(root + "/eviction");
+    test_overwrite_updates_index(root + "/overwrite");
+    test_stale_tmp_removed_on_start(root + "/stale_tmp");
+    remove_dir(root);
+    return test_result("kv_store_test");
+}
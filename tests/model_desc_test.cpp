@@ -0,0 +1,96 @@
+#include <string>
+#include <vector>
+
+#include "pb_sdk/model_desc.h"
+#include "test_util.h"
+
+namespace {
+
+CnnChatCompletions make_request(const std::string& data_type, const std::vector<int64_t>& shape, size_t bytes) {
+    CnnChatCompletions request;
+    CnnChatData part;
+    part.data_type = data_type;
+    part.data_shape = shape;
+    part.data.resize(bytes);
+    request.data_info.push_back(std::move(part));
+    return request;
+}
+
+void test_yolov8s_desc() {
+    auto desc = describe_model(YOLOV8S);
+    CHECK(desc.has_value());
+    if (!desc) {
+        return;
+    }
+    CHECK(desc->inputs.size() == 1);
+    CHECK(desc->inputs[0].nbytes() == 1u * 3 * 640 * 640 * 2);
+    // 后处理按 [1, 420, 20, 38] 读取输出，共 8400 x 38 个 float16
+    CHECK(desc->outputs.size() == 1);
+    CHECK((desc->outputs[0].shape == std::vector<int64_t>{1, 38, 420, 20}));
+    CHECK(desc->outputs[0].layout == "NHWC");
+    CHECK(desc->outputs[0].nbytes() == 8400u * 38 * 2);
+    CHECK(!describe_model(-12345).has_value());
+}
+
+void test_validate_float16() {
+    ModelDesc desc = describe_model(YOLOV8S).value();
+    std::string error;
+    CHECK(validate_request(desc, make_request("float16", {1, 3, 640, 640}, 1u * 3 * 640 * 640 * 2), &error) ==
+          PBNN_SUCCESS);
+    CHECK(error.empty());
+
+    // 数据类型不一致
+    CHECK(validate_request(desc, make_request("uint8_t", {1, 3, 640, 640}, 1u * 3 * 640 * 640), &error) ==
+          PBNN_INVALID_ARGUMENT);
+    CHECK(error.find("data type") != std::string::npos);
+
+    // 形状不一致（字节数相同）
+    error.clear();
+    CHECK(validate_request(desc, make_request("float16", {1, 3, 320, 1280}, 1u * 3 * 640 * 640 * 2), &error) ==
+          PBNN_INVALID_ARGUMENT);
+    CHECK(error.find("shape") != std::string::npos);
+
+    // 字节数不一致
+    error.clear();
+    CHECK(validate_request(desc, make_request("float16", {1, 3, 640, 640}, 100), &error) == PBNN_INVALID_ARGUMENT);
+    CHECK(error.find("bytes") != std::string::npos);
+
+    // 输入个数不一致
+    CnnChatCompletions empty;
+    CHECK(validate_request(desc, empty, &error) == PBNN_INVALID_ARGUMENT);
+}
+
+void test_validate_uint8_nhwc() {
+    // uint8 输入按 NHWC 排布发送，但形状按逻辑 NCHW 上报
+    ModelDesc desc = describe_model(YOLOV8S).value();
+    desc.inputs[0].data_type = "uint8_t";
+    desc.inputs[0].layout = "NHWC";
+    const size_t bytes = 1u * 640 * 640 * 3;
+    CHECK(validate_request(desc, make_request("uint8_t", {1, 3, 640, 640}, bytes)) == PBNN_SUCCESS);
+    CHECK(validate_request(desc, make_request("uint8_t", {1, 640, 640, 3}, bytes)) == PBNN_INVALID_ARGUMENT);
+    CHECK(validate_request(desc, make_request("float16", {1, 3, 640, 640}, bytes * 2)) == PBNN_INVALID_ARGUMENT);
+    // 修改的是副本，注册表中的描述不受影响
+    CHECK(describe_model(YOLOV8S)->inputs[0].data_type == "float16");
+}
+
+void test_register_overrides() {
+    ModelDesc desc = describe_model(YOLOV8S).value();
+    ModelDesc custom = desc;
+    custom.name = "yolov8s_u8";
+    custom.inputs[0].data_type = "uint8_t";
+    register_model_desc(custom);
+    CHECK(describe_model(YOLOV8S)->name == "yolov8s_u8");
+    CHECK(describe_model(YOLOV8S)->inputs[0].nbytes() == 1u * 3 * 640 * 640);
+    register_model_desc(desc);
+    CHECK(describe_model(YOLOV8S)->inputs[0].data_type == "float16");
+}
+
+}  // namespace
+
+int main() {
+    test_yolov8s_desc();
+    test_validate_float16();
+    test_validate_uint8_nhwc();
+    test_register_overrides();
+    return test_result("model_desc_test");
+}
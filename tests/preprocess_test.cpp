@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "yolov8s_pose/preprocess.h"
+#include "test_util.h"
+
+namespace {
+
+constexpr int kWidth = 320;
+constexpr int kHeight = 180;
+constexpr int kImgsz = 160;
+
+/**
+ * @brief 平滑的合成 YUV 4:2:0 帧，颜色转换后不会触发截断
+ */
+struct SyntheticYuv {
+    std::vector<uint8_t> y;
+    std::vector<uint8_t> u;
+    std::vector<uint8_t> v;
+
+    SyntheticYuv() : y(kWidth * kHeight), u(kWidth * kHeight / 4), v(kWidth * kHeight / 4) {
+        for (int row = 0; row < kHeight; ++row) {
+            for (int col = 0; col < kWidth; ++col) {
+                y[row * kWidth + col] = static_cast<uint8_t>(60 + 100 * col / kWidth + 40 * row / kHeight);
+            }
+        }
+        for (int row = 0; row < kHeight / 2; ++row) {
+            for (int col = 0; col < kWidth / 2; ++col) {
+                u[row * kWidth / 2 + col] = static_cast<uint8_t>(110 + 30 * col / (kWidth / 2));
+                v[row * kWidth / 2 + col] = static_cast<uint8_t>(150 - 30 * row / (kHeight / 2));
+            }
+        }
+    }
+
+    /**
+     * @brief 参考转换：逐像素 BT.601 有限范围 YUV -> BGR，色度取最近邻
+     */
+    cv::Mat to_bgr() const {
+        cv::Mat bgr(kHeight, kWidth, CV_8UC3);
+        auto to_u8 = [](float value) {
+            return static_cast<uint8_t>(std::lround(std::min(std::max(value, 0.0f), 255.0f)));
+        };
+        for (int row = 0; row < kHeight; ++row) {
+            uint8_t* dst = bgr.ptr<uint8_t>(row);
+            for (int col = 0; col < kWidth; ++col) {
+                const int ci = (row / 2) * (kWidth / 2) + col / 2;
+                const float c = (y[row * kWidth + col] - 16.0f) * 1.164f;
+                const float d = u[ci] - 128.0f;
+                const float e = v[ci] - 128.0f;
+                dst[col * 3] = to_u8(c + 2.018f * d);
+                dst[col * 3 + 1] = to_u8(c - 0.813f * e - 0.391f * d);
+                dst[col * 3 + 2] = to_u8(c + 1.596f * e);
+            }
+        }
+        return bgr;
+    }
+};
+
+/**
+ * @brief 比较两个 [1, 3, H, W] Float16 张量，返回最大绝对误差
+ */
+double max_abs_diff(const torch::Tensor& a, const torch::Tensor& b) {
+    const at::Half* pa = a.data_ptr<at::Half>();
+    const at::Half* pb = b.data_ptr<at::Half>();
+    double diff = 0.0;
+    for (int64_t i = 0; i < a.numel(); ++i) {
+        diff = std::max(diff, static_cast<double>(std::fabs(static_cast<float>(pa[i]) - static_cast<float>(pb[i]))));
+    }
+    return diff;
+}
+
+/**
+ * @brief 检查 letterbox 边框区域的值与 Mat 路径完全一致
+ */
+void check_padding_equal(const torch::Tensor& a, const torch::Tensor& b, const LetterboxPlan& plan) {
+    const at::Half* pa = a.data_ptr<at::Half>();
+    const at::Half* pb = b.data_ptr<at::Half>();
+    const int out_w = plan.out_size.width;
+    const size_t plane = static_cast<size_t>(out_w) * plan.out_size.height;
+    for (int c = 0; c < 3; ++c) {
+        for (int row = 0; row < plan.top; ++row) {
+            for (int col = 0; col < out_w; ++col) {
+                const size_t i = plane * c + static_cast<size_t>(row) * out_w + col;
+                CHECK(static_cast<float>(pa[i]) == static_cast<float>(pb[i]));
+            }
+        }
+    }
+}
+
+void test_yuv_matches_mat_path() {
+    SyntheticYuv yuv;
+    yolov8sPreprocess preprocessor;
+    auto plan = LetterboxPlanCache::instance().get(cv::Size(kWidth, kHeight), kImgsz);
+    torch::Tensor expected = preprocessor.preprocess(yuv.to_bgr(), *plan);
+
+    // NV12：交织 UV 平面
+    std::vector<uint8_t> uv(yuv.u.size() * 2);
+    for (size_t i = 0; i < yuv.u.size(); ++i) {
+        uv[i * 2] = yuv.u[i];
+        uv[i * 2 + 1] = yuv.v[i];
+    }
+    YuvFrame nv12;
+    nv12.format = YuvFormat::NV12;
+    nv12.width = kWidth;
+    nv12.height = kHeight;
+    nv12.planes[0] = yuv.y.data();
+    nv12.planes[1] = uv.data();
+
+    YuvFrame i420;
+    i420.format = YuvFormat::I420;
+    i420.width = kWidth;
+    i420.height = kHeight;
+    i420.planes[0] = yuv.y.data();
+    i420.planes[1] = yuv.u.data();
+    i420.planes[2] = yuv.v.data();
+
+    // YUYV：4:2:2，垂直方向复用 4:2:0 的色度行
+    std::vector<uint8_t> yuyv(kWidth * kHeight * 2);
+    for (int row = 0; row < kHeight; ++row) {
+        for (int col = 0; col < kWidth; ++col) {
+            const int ci = (row / 2) * (kWidth / 2) + col / 2;
+            uint8_t* px = &yuyv[(row * kWidth + col) * 2];
+            px[0] = yuv.y[row * kWidth + col];
+            px[1] = (col % 2 == 0) ? yuv.u[ci] : yuv.v[ci];
+        }
+    }
+    YuvFrame packed;
+    packed.format = YuvFormat::YUYV;
+    packed.width = kWidth;
+    packed.height = kHeight;
+    packed.planes[0] = yuyv.data();
+
+    // 误差来源：参考路径的 uint8 取整、色度最近邻与插值顺序不同，以及 float16 量化
+    constexpr double kTolerance = 2.0 / 255.0;
+    for (const YuvFrame* frame : {&nv12, &i420, &packed}) {
+        torch::Tensor fused = preprocessor.preprocess(*frame, *plan);
+        CHECK(fused.numel() == expected.numel());
+        CHECK(max_abs_diff(fused, expected) <= kTolerance);
+        check_padding_equal(fused, expected, *plan);
+    }
+}
+
+void test_output_reuse_repaints_padding() {
+    SyntheticYuv yuv;
+    yolov8sPreprocess preprocessor;
+    auto plan = LetterboxPlanCache::instance().get(cv::Size(kWidth, kHeight), kImgsz);
+    torch::Tensor expected = preprocessor.preprocess(yuv.to_bgr(), *plan);
+
+    // 复用的输出张量先写入脏数据，填充区与有效区都必须被完整覆盖
+    torch::Tensor out = torch::empty({1, 3, kImgsz, kImgsz}, torch::dtype(torch::kHalf));
+    at::Half* dirty = out.data_ptr<at::Half>();
+    std::fill(dirty, dirty + out.numel(), at::Half(0.5f));
+
+    YuvFrame i420;
+    i420.format = YuvFormat::I420;
+    i420.width = kWidth;
+    i420.height = kHeight;
+    i420.planes[0] = yuv.y.data();
+    i420.planes[1] = yuv.u.data();
+    i420.planes[2] = yuv.v.data();
+    torch::Tensor fused = preprocessor.preprocess(i420, *plan, out);
+    CHECK(fused.data_ptr() == out.data_ptr());
+    CHECK(max_abs_diff(fused, expected) <= 2.0 / 255.0);
+    check_padding_equal(fused, expected, *plan);
+}
+
+void test_u8_matches_mat_path() {
+    SyntheticYuv yuv;
+    yolov8sPreprocess preprocessor;
+    const cv::Mat bgr = yuv.to_bgr();
+    auto plan = LetterboxPlanCache::instance().get(cv::Size(kWidth, kHeight), kImgsz);
+    torch::Tensor expected = preprocessor.preprocess(bgr, *plan);
+    torch::Tensor u8 = preprocessor.preprocess_u8(bgr, *plan);
+
+    // u8 为 NHWC（RGB），Mat 路径为 NCHW；两者仅差 /255 与 float16 量化
+    CHECK(u8.scalar_type() == torch::kUInt8);
+    CHECK(u8.numel() == expected.numel());
+    const uint8_t* pu = u8.data_ptr<uint8_t>();
+    const at::Half* pe = expected.data_ptr<at::Half>();
+    const size_t plane = static_cast<size_t>(kImgsz) * kImgsz;
+    double diff = 0.0;
+    for (size_t i = 0; i < plane; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            const double a = pu[i * 3 + c] / 255.0;
+            const double b = static_cast<float>(pe[plane * c + i]);
+            diff = std::max(diff, std::fabs(a - b));
+        }
+    }
+    CHECK(diff <= 1.0 / 255.0 + 1e-3);
+}
+
+void test_plan_cache_evicts_lru() {
+    auto& cache = LetterboxPlanCache::instance();
+    cache.clear();
+    auto hot = cache.get(cv::Size(1000, 500), kImgsz);
+    auto cold = cache.get(cv::Size(1000, 501), kImgsz);
+    // 填满缓存，期间持续访问 hot，cold 成为最久未使用的计划
+    for (int i = 0; i < static_cast<int>(LetterboxPlanCache::kMaxPlans); ++i) {
+        CHECK(cache.get(cv::Size(1000, 500), kImgsz) == hot);
+        cache.get(cv::Size(800, 600 + i), kImgsz);
+    }
+    CHECK(cache.get(cv::Size(1000, 500), kImgsz) == hot);
+    CHECK(cache.get(cv::Size(1000, 501), kImgsz) != cold);
+}
+
+void test_ratio_pad_targets_canvas() {
+    auto plan = LetterboxPlanCache::instance().get(cv::Size(kWidth, kHeight), kImgsz);
+    auto same = plan->ratio_pad();
+    CHECK(same.first.dim() == 0);
+    CHECK_NEAR(same.first.item<float>(), plan->ratio.x, 1e-6);
+    CHECK(same.second.size() == 2);
+    CHECK_NEAR(same.second[0], plan->left, 1e-6);
+    CHECK_NEAR(same.second[1], plan->top, 1e-6);
+
+    // 原图为预处理图像的 2 倍（DCT 缩放解码），缩放比例减半，填充量不变
+    auto canvas = plan->ratio_pad(cv::Size(kWidth * 2, kHeight * 2));
+    CHECK_NEAR(canvas.first.item<float>(), plan->ratio.x / 2.0f, 1e-6);
+    CHECK_NEAR(canvas.second[1], plan->top, 1e-6);
+}
+
+}  // namespace
+
+int main() {
+    test_yuv_matches_mat_path();
+    test_output_reuse_repaints_padding();
+    test_u8_matches_mat_path();
+    test_plan_cache_evicts_lru();
+    test_ratio_pad_targets_canvas();
+    return test_result("preprocess_test");
+}
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <vector>
+
+#include "pb_sdk/sampler.h"
+#include "test_util.h"
+
+namespace {
+
+SamplerConfig plain_config() {
+    SamplerConfig config;
+    config.temperature = 1.0f;
+    config.top_k = 0;
+    config.meta_top_k = 0;
+    config.top_p = 1.0f;
+    config.seed = 7;
+    return config;
+}
+
+/**
+ * @brief 按 logit 降序排列的 token，用于计算期望的候选集合
+ */
+std::vector<int> ranked(const std::vector<float>& logits) {
+    std::vector<int> order(logits.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = static_cast<int>(i);
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return logits[a] > logits[b]; });
+    return order;
+}
+
+std::set<int> sample_many(const SamplerConfig& config, const std::vector<float>& logits, int draws) {
+    TokenSampler sampler(static_cast<int>(logits.size()), config);
+    std::set<int> tokens;
+    for (int i = 0; i < draws; ++i) {
+        std::vector<float> copy = logits;
+        tokens.insert(sampler.sample(copy.data()));
+    }
+    return tokens;
+}
+
+std::vector<float> spread_logits(int vocab) {
+    // 互不相同的 logit，token 顺序与大小无关
+    std::vector<float> logits(vocab);
+    for (int i = 0; i < vocab; ++i) {
+        logits[i] = static_cast<float>((i * 7919) % vocab) / vocab * 8.0f - 4.0f;
+    }
+    return logits;
+}
+
+void test_top_k_membership() {
+    const std::vector<float> logits = spread_logits(4096);
+    const std::vector<int> order = ranked(logits);
+    SamplerConfig config = plain_config();
+    config.top_k = 5;
+    config.temperature = 5.0f;
+    std::set<int> drawn = sample_many(config, logits, 2000);
+    std::set<int> expected(order.begin(), order.begin() + 5);
+    // 温度很高时 5 个候选都应被抽到，且不会抽到其他 token
+    CHECK(drawn == expected);
+
+    // top_k 不限时由 meta_top_k 限制候选集合
+    config.top_k = 0;
+    config.meta_top_k = 3;
+    drawn = sample_many(config, logits, 2000);
+    CHECK(drawn == std::set<int>(order.begin(), order.begin() + 3));
+
+    config.top_k = 2;
+    drawn = sample_many(config, logits, 2000);
+    CHECK(drawn == std::set<int>(order.begin(), order.begin() + 2));
+}
+
+void test_top_p_membership() {
+    // 概率 0.5, 0.25, 0.125, ...：top_p=0.8 时需要前 3 个
+    const int vocab = 20;
+    std::vector<float> logits(vocab);
+    for (int i = 0; i < vocab; ++i) {
+        logits[(i * 3) % vocab] = -static_cast<float>(i) * std::log(2.0f);
+    }
+    const std::vector<int> order = ranked(logits);
+    SamplerConfig config = plain_config();
+    config.top_p = 0.8f;
+    CHECK(sample_many(config, logits, 2000) == std::set<int>(order.begin(), order.begin() + 3));
+
+    // 与 top_k 组合时 top_p 在 top_k 候选内归一化（4/7, 2/7, 1/7）：0.9 需要全部 3 个，0.6 需要前 2 个
+    config.top_k = 3;
+    config.top_p = 0.9f;
+    CHECK(sample_many(config, logits, 2000) == std::set<int>(order.begin(), order.begin() + 3));
+    config.top_p = 0.6f;
+    CHECK(sample_many(config, logits, 2000) == std::set<int>(order.begin(), order.begin() + 2));
+}
+
+void test_min_p_membership() {
+    const std::vector<float> logits = spread_logits(50000);
+    const std::vector<int> order = ranked(logits);
+    SamplerConfig config = plain_config();
+    config.min_p = 0.9f;
+    const float floor = logits[order[0]] + std::log(0.9f);
+    std::set<int> expected;
+    for (int token : order) {
+        if (logits[token] >= floor) {
+            expected.insert(token);
+        }
+    }
+    CHECK(expected.size() > 1);
+    std::set<int> drawn = sample_many(config, logits, 4000);
+    CHECK(std::includes(expected.begin(), expected.end(), drawn.begin(), drawn.end()));
+    CHECK(drawn.size() > 1);
+}
+
+void test_penalties_split_prompt_and_generated() {
+    SamplerConfig config = plain_config();
+    config.temperature = 0.0f;
+    config.repetition_penalty = 2.0f;
+    config.presence_penalty = 1.0f;
+    config.frequency_penalty = 0.5f;
+    TokenSampler sampler(4, config);
+    sampler.accept_prompt(0);
+    sampler.accept(1);
+    sampler.accept(1);
+    sampler.accept_prompt(1);
+
+    std::vector<float> logits{4.0f, 4.0f, -1.0f, 3.0f};
+    sampler.sample(logits.data());
+    // prompt token 只受 repetition penalty 影响
+    CHECK_NEAR(logits[0], 2.0f, 1e-6f);
+    // 已生成两次：4 / 2 - 0.5 * 2 - 1
+    CHECK_NEAR(logits[1], 0.0f, 1e-6f);
+    CHECK_NEAR(logits[2], -1.0f, 1e-6f);
+    CHECK_NEAR(logits[3], 3.0f, 1e-6f);
+
+    sampler.reset();
+    logits = {4.0f, 4.0f, -1.0f, 3.0f};
+    CHECK(sampler.sample(logits.data()) == 0);
+    CHECK_NEAR(logits[1], 4.0f, 1e-6f);
+}
+
+void test_seeded_determinism() {
+    const std::vector<float> logits = spread_logits(1000);
+    SamplerConfig config = plain_config();
+    config.top_k = 40;
+    config.top_p = 0.95f;
+    config.frequency_penalty = 0.3f;
+    TokenSampler a(1000, config);
+    TokenSampler b(1000, config);
+    std::set<int> distinct;
+    bool same = true;
+    for (int i = 0; i < 200; ++i) {
+        std::vector<float> la = logits;
+        std::vector<float> lb = logits;
+        int token = a.sample_and_accept(la.data());
+        same = same && token == b.sample_and_accept(lb.data());
+        distinct.insert(token);
+    }
+    CHECK(same);
+    CHECK(distinct.size() > 1);
+}
+
+void test_from_request() {
+    ChatCompletionsRequest request;
+    request.top_k = 0;
+    request.meta_top_k = 64;
+    request.top_p = 0.7f;
+    request.seed = 3;
+    SamplerConfig config = SamplerConfig::from_request(request);
+    CHECK(config.top_k == 0);
+    CHECK(config.meta_top_k == 64);
+    CHECK_NEAR(config.top_p, 0.7f, 1e-6f);
+    CHECK(config.seed && *config.seed == 3);
+}
+
+}  // namespace
+
+int main() {
+    test_top_k_membership();
+    test_top_p_membership();
+    test_min_p_membership();
+    test_penalties_split_prompt_and_generated();
+    test_seeded_determinism();
+    test_from_request();
+    return test_result("sampler_test");
+}
@@ -0,0 +1,212 @@
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "pb_sdk/stream_delivery.h"
+#include "test_util.h"
+
+namespace {
+
+ChatCompletionChunkObject make_chunk(const std::string& text, int completion_tokens) {
+    ChatCompletionChunkObject chunk;
+    chunk.id = "chatcmpl-test";
+    chunk.model = "test-model";
+    chunk.created = 1000 + completion_tokens;
+    chunk.usage = Usage{completion_tokens, 7, 7 + completion_tokens};
+    chunk.metric = Metric{};
+    chunk.metric.decode_time = completion_tokens;
+    chunk.choices.assign(1, ChatCompletionChunkChoice());
+    chunk.choices.front().index = 0;
+    chunk.choices.front().delta.content = text;
+    return chunk;
+}
+
+ChatCompletionChunkObject make_role_chunk() {
+    ChatCompletionChunkObject chunk = make_chunk("", 0);
+    chunk.choices.front().delta.content.reset();
+    chunk.choices.front().delta.role = "assistant";
+    return chunk;
+}
+
+ChatCompletionChunkObject make_finish_chunk(int completion_tokens) {
+    ChatCompletionChunkObject chunk = make_chunk("", completion_tokens);
+    chunk.choices.front().delta.content.reset();
+    chunk.choices.front().finish_reason = "stop";
+    return chunk;
+}
+
+/**
+ * @brief 记录投递结果的回调，可在 hold() 之后阻塞，模拟慢消费者
+ */
+class Recorder
+{
+public:
+    stream_cb_t callback() {
+        return [this](const ChatCompletionChunkObject& chunk) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_chunks.push_back(chunk);
+            m_cv.notify_all();
+            m_cv.wait(lock, [this] { return !m_hold; });
+        };
+    }
+
+    void hold() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hold = true;
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hold = false;
+        m_cv.notify_all();
+    }
+
+    bool wait_for_count(size_t count) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_cv.wait_for(lock, std::chrono::seconds(2), [&] { return m_chunks.size() >= count; });
+    }
+
+    bool wait_for_text(const std::string& text) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_cv.wait_for(lock, std::chrono::seconds(2), [&] { return text_locked() == text; });
+    }
+
+    bool wait_for_finish() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_cv.wait_for(lock, std::chrono::seconds(2), [&] {
+            return !m_chunks.empty() && m_chunks.back().choices.front().finish_reason.has_value();
+        });
+    }
+
+    std::vector<ChatCompletionChunkObject> chunks() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_chunks;
+    }
+
+    std::string text() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return text_locked();
+    }
+
+private:
+    std::string text_locked() const {
+        std::string text;
+        for (const auto& chunk : m_chunks) {
+            for (const auto& choice : chunk.choices) {
+                text += choice.delta.content.value_or("");
+            }
+        }
+        return text;
+    }
+
+    std::mutex                              m_mutex;
+    std::condition_variable                 m_cv;
+    std::vector<ChatCompletionChunkObject>  m_chunks;
+    bool                                    m_hold = false;
+};
+
+void test_ordering_is_preserved() {
+    Recorder recorder;
+    std::string expected;
+    {
+        StreamDelivery delivery(recorder.callback());
+        stream_cb_t produce = delivery.producer();
+        produce(make_role_chunk());
+        for (int i = 1; i <= 200; ++i) {
+            std::string piece = "t" + std::to_string(i) + " ";
+            expected += piece;
+            produce(make_chunk(piece, i));
+        }
+        produce(make_finish_chunk(200));
+        delivery.close();
+        CHECK(delivery.stats().events == 202);
+    }
+    std::vector<ChatCompletionChunkObject> chunks = recorder.chunks();
+    CHECK(chunks.size() >= 3);
+    CHECK(chunks.front().choices.front().delta.role.value_or("") == "assistant");
+    CHECK(chunks.back().choices.front().finish_reason.value_or("") == "stop");
+    CHECK(recorder.text() == expected);
+    for (const auto& chunk : chunks) {
+        CHECK(chunk.id == "chatcmpl-test");
+        CHECK(chunk.model == "test-model");
+    }
+}
+
+void test_idle_consumer_gets_each_chunk() {
+    // 消费者没有积压时不等待合并周期，每个增量单独且及时投递
+    Recorder recorder;
+    StreamDelivery delivery(recorder.callback());
+    stream_cb_t produce = delivery.producer();
+    produce(make_role_chunk());
+    CHECK(recorder.wait_for_count(1));
+    for (int i = 1; i <= 20; ++i) {
+        produce(make_chunk("x", i));
+        CHECK(recorder.wait_for_count(static_cast<size_t>(i) + 1));
+    }
+    delivery.close();
+    StreamDeliveryStats stats = delivery.stats();
+    CHECK(stats.events == 21);
+    CHECK(stats.delivered == 21);
+}
+
+void test_backlog_is_coalesced_with_latest_usage() {
+    Recorder recorder;
+    StreamDelivery delivery(recorder.callback());
+    stream_cb_t produce = delivery.producer();
+    recorder.hold();
+    produce(make_role_chunk());
+    CHECK(recorder.wait_for_count(1));
+    // 回调阻塞期间积压的文本合并为一次投递
+    std::string expected;
+    for (int i = 1; i <= 50; ++i) {
+        expected += "y";
+        produce(make_chunk("y", i));
+    }
+    recorder.release();
+    CHECK(recorder.wait_for_text(expected));
+    delivery.close();
+
+    std::vector<ChatCompletionChunkObject> chunks = recorder.chunks();
+    CHECK(chunks.size() < 51);
+    const ChatCompletionChunkObject& last = chunks.back();
+    CHECK(last.usage.completion_tokens == 50);
+    CHECK(last.usage.total_tokens == 57);
+    CHECK(last.created == 1050);
+    CHECK_NEAR(last.metric.decode_time, 50.0, 1e-9);
+}
+
+void test_overflow_drains_without_further_pushes() {
+    Recorder recorder;
+    StreamDeliveryConfig config;
+    config.ring_capacity = 2;
+    StreamDelivery delivery(recorder.callback(), config);
+    stream_cb_t produce = delivery.producer();
+    recorder.hold();
+    produce(make_role_chunk());
+    CHECK(recorder.wait_for_count(1));
+    std::string expected;
+    for (int i = 1; i <= 100; ++i) {
+        std::string piece = std::to_string(i) + ",";
+        expected += piece;
+        produce(make_chunk(piece, i));
+    }
+    produce(make_finish_chunk(100));
+    recorder.release();
+    // 不再 push、也不 close，溢出的事件仍由投递线程送达
+    CHECK(recorder.wait_for_finish());
+    CHECK(recorder.text() == expected);
+    delivery.close();
+    CHECK(delivery.stats().overflowed > 0);
+}
+
+}  // namespace
+
+int main() {
+    test_ordering_is_preserved();
+    test_idle_consumer_gets_each_chunk();
+    test_backlog_is_coalesced_with_latest_usage();
+    test_overflow_drains_without_further_pushes();
+    return test_result("stream_delivery_test");
+}
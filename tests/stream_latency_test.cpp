@@ -0,0 +1,112 @@
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "pb_sdk/stream_latency.h"
+#include "test_util.h"
+
+namespace {
+
+ChatCompletionChunkObject make_chunk(const std::string& text) {
+    ChatCompletionChunkObject chunk;
+    chunk.choices.assign(1, ChatCompletionChunkChoice());
+    chunk.choices.front().delta.content = text;
+    return chunk;
+}
+
+ChatCompletionChunkObject make_role_chunk() {
+    ChatCompletionChunkObject chunk = make_chunk("");
+    chunk.choices.front().delta.content.reset();
+    chunk.choices.front().delta.role = "assistant";
+    return chunk;
+}
+
+ChatCompletionChunkObject make_finish_chunk() {
+    ChatCompletionChunkObject chunk = make_chunk("");
+    chunk.choices.front().delta.content.reset();
+    chunk.choices.front().finish_reason = "stop";
+    return chunk;
+}
+
+void sleep_ms(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void test_wrap_with_timed_chunks() {
+    StreamLatencyRecorder recorder;
+    int forwarded = 0;
+    stream_cb_t callback = recorder.wrap([&](const ChatCompletionChunkObject&) { forwarded++; });
+
+    recorder.start();
+    // role chunk 与空内容 chunk 先于首个 token 到达，不计入 TTFT
+    sleep_ms(20);
+    callback(make_role_chunk());
+    sleep_ms(20);
+    callback(make_chunk(""));
+    sleep_ms(20);
+    callback(make_chunk("a"));
+    for (int i = 0; i < 8; ++i) {
+        sleep_ms(2);
+        callback(make_chunk("b"));
+    }
+    // 一次长停顿，模拟其他请求的 prefill
+    sleep_ms(100);
+    callback(make_chunk("c"));
+    sleep_ms(2);
+    callback(make_finish_chunk());
+
+    StreamLatencyReport report = recorder.report();
+    CHECK(forwarded == 13);
+    CHECK(report.chunks == 13);
+    CHECK(report.content_chunks == 10);
+    CHECK(report.ttft_ms >= 60.0);
+    CHECK(report.total_ms >= report.ttft_ms + 100.0);
+    CHECK(report.itl_max_ms >= 100.0);
+    CHECK(report.itl_p50_ms >= 2.0 && report.itl_p50_ms < 100.0);
+    CHECK(report.itl_p90_ms <= report.itl_p99_ms);
+    // 最近秩：9 个间隔时 p99 取第 ceil(0.99 * 9) = 9 个，即最大值
+    CHECK(report.itl_p99_ms == report.itl_max_ms);
+}
+
+void test_restart_clears_previous_request() {
+    StreamLatencyRecorder recorder;
+    stream_cb_t callback = recorder.wrap(nullptr);
+    recorder.start();
+    callback(make_chunk("a"));
+    callback(make_chunk("b"));
+
+    recorder.start();
+    sleep_ms(10);
+    callback(make_chunk("c"));
+    StreamLatencyReport report = recorder.report();
+    CHECK(report.chunks == 1);
+    CHECK(report.content_chunks == 1);
+    CHECK(report.ttft_ms >= 10.0);
+    CHECK(report.itl_max_ms == 0.0);
+}
+
+void test_report_without_start() {
+    StreamLatencyRecorder recorder;
+    stream_cb_t callback = recorder.wrap(nullptr);
+    StreamLatencyReport report = recorder.report();
+    CHECK(report.chunks == 0);
+    CHECK(report.ttft_ms == 0.0);
+
+    // 未调用 start() 时没有请求发出时刻，不把 chunk 到达时刻当作延迟
+    callback(make_chunk("a"));
+    callback(make_chunk("b"));
+    report = recorder.report();
+    CHECK(report.chunks == 0);
+    CHECK(report.ttft_ms == 0.0);
+    CHECK(report.total_ms == 0.0);
+    CHECK(report.itl_max_ms == 0.0);
+}
+
+}  // namespace
+
+int main() {
+    test_wrap_with_timed_chunks();
+    test_restart_clears_previous_request();
+    test_report_without_start();
+    return test_result("stream_latency_test");
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cmath>
+#include <iostream>
+
+/**
+ * @brief 单元测试的失败计数，CHECK 失败时累加，main 以 test_result() 作为返回值
+ */
+inline int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                                              \
+    do {                                                                                         \
+        if (!(cond)) {                                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed" << std::endl; \
+            test_failures()++;                                                                   \
+        }                                                                                        \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                                            \
+    do {                                                                                                 \
+        const double check_a_ = static_cast<double>(a);                                                  \
+        const double check_b_ = static_cast<double>(b);                                                  \
+        if (!(std::fabs(check_a_ - check_b_) <= (tol))) {                                                \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK_NEAR(" #a ", " #b ") failed: " << check_a_ \
+                      << " vs " << check_b_ << std::endl;                                                \
+            test_failures()++;                                                                           \
+        }                                                                                                \
+    } while (0)
+
+/**
+ * @brief 打印测试结果并返回进程退出码
+ */
+inline int test_result(const char* name) {
+    if (test_failures() == 0) {
+        std::cout << name << ": passed" << std::endl;
+        return 0;
+    }
+    std::cout << name << ": " << test_failures() << " check(s) failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "pb_sdk/token_radix_tree.h"
+#include "test_util.h"
+
+namespace {
+
+size_t match(const TokenRadixTree& tree, const std::vector<int>& tokens) {
+    return tree.longest_match(tokens.data(), tokens.size());
+}
+
+void insert(TokenRadixTree& tree, const std::vector<int>& tokens) {
+    tree.insert(tokens.data(), tokens.size());
+}
+
+bool erase(TokenRadixTree& tree, const std::vector<int>& tokens) {
+    return tree.erase(tokens.data(), tokens.size());
+}
+
+void test_longest_match_with_shared_prefixes() {
+    TokenRadixTree tree;
+    CHECK(match(tree, {1, 2, 3}) == 0);
+
+    insert(tree, {1, 2, 3, 4});
+    insert(tree, {1, 2});
+    insert(tree, {1, 2, 5, 6, 7});
+    insert(tree, {1, 2});
+    CHECK(tree.size() == 3);
+
+    CHECK(match(tree, {1, 2, 3, 4, 9}) == 4);
+    CHECK(match(tree, {1, 2, 3}) == 2);
+    CHECK(match(tree, {1, 2, 5, 6}) == 2);
+    CHECK(match(tree, {1, 2, 5, 6, 7}) == 5);
+    CHECK(match(tree, {1}) == 0);
+    CHECK(match(tree, {2, 1}) == 0);
+}
+
+void test_erase_keeps_other_prefixes() {
+    TokenRadixTree tree;
+    insert(tree, {1, 2, 3, 4});
+    insert(tree, {1, 2});
+    insert(tree, {1, 2, 5, 6, 7});
+
+    CHECK(!erase(tree, {1, 2, 3}));
+    CHECK(erase(tree, {1, 2}));
+    CHECK(!erase(tree, {1, 2}));
+    CHECK(tree.size() == 2);
+    CHECK(match(tree, {1, 2, 9}) == 0);
+    CHECK(match(tree, {1, 2, 3, 4}) == 4);
+    CHECK(match(tree, {1, 2, 5, 6, 7, 8}) == 5);
+
+    // 删除分支后剩余节点被合并，仍能完整匹配
+    CHECK(erase(tree, {1, 2, 5, 6, 7}));
+    CHECK(match(tree, {1, 2, 3, 4}) == 4);
+    CHECK(match(tree, {1, 2, 5, 6, 7}) == 0);
+    insert(tree, {1, 2, 3});
+    CHECK(match(tree, {1, 2, 3, 9}) == 3);
+
+    tree.clear();
+    CHECK(tree.size() == 0);
+    CHECK(match(tree, {1, 2, 3, 4}) == 0);
+}
+
+void test_matches_linear_scan() {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> token(0, 3);
+    std::uniform_int_distribution<int> length(1, 8);
+    TokenRadixTree tree;
+    std::vector<std::vector<int>> stored;
+    for (int round = 0; round < 2000; ++round) {
+        std::vector<int> tokens(static_cast<size_t>(length(rng)));
+        for (auto& t : tokens) {
+            t = token(rng);
+        }
+        if (round % 3 == 2 && !stored.empty()) {
+            std::vector<int> victim = stored[static_cast<size_t>(rng()) % stored.size()];
+            CHECK(erase(tree, victim));
+            stored.erase(std::find(stored.begin(), stored.end(), victim));
+        } else if (std::find(stored.begin(), stored.end(), tokens) == stored.end()) {
+            insert(tree, tokens);
+            stored.push_back(tokens);
+        }
+
+        std::vector<int> query(8);
+        for (auto& t : query) {
+            t = token(rng);
+        }
+        size_t expected = 0;
+        for (const auto& prefix : stored) {
+            if (prefix.size() > expected && std::equal(prefix.begin(), prefix.end(), query.begin())) {
+                expected = prefix.size();
+            }
+        }
+        CHECK(match(tree, query) == expected);
+        CHECK(tree.size() == stored.size());
+    }
+}
+
+}  // namespace
+
+int main() {
+    test_longest_match_with_shared_prefixes();
+    test_erase_keeps_other_prefixes();
+    test_matches_linear_scan();
+    return test_result("token_radix_tree_test");
+}
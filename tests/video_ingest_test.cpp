@@ -0,0 +1,143 @@
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "pb_sdk/video_ingest.h"
+#include "test_util.h"
+
+namespace {
+
+/**
+ * @brief 灰度值沿 x 方向单调变化的图像，step 为相邻列的差值
+ */
+cv::Mat ramp(int rows, int cols, int start, int step) {
+    cv::Mat gray(rows, cols, CV_8UC1);
+    for (int y = 0; y < rows; ++y) {
+        uint8_t* row = gray.ptr<uint8_t>(y);
+        for (int x = 0; x < cols; ++x) {
+            row[x] = static_cast<uint8_t>(start + step * x);
+        }
+    }
+    return gray;
+}
+
+/**
+ * @brief 构造已解码的帧：hash 直接给定，缩略图为常数灰度
+ */
+VideoFrame make_frame(double timestamp_ms, uint64_t hash, int thumb_value) {
+    VideoFrame frame;
+    frame.timestamp_ms = timestamp_ms;
+    frame.image = cv::Mat(8, 8, CV_8UC3, cv::Scalar::all(thumb_value));
+    frame.hash = hash;
+    frame.thumb = cv::Mat(32, 32, CV_8UC1, cv::Scalar(thumb_value));
+    return frame;
+}
+
+std::vector<double> timestamps_of(const std::vector<VideoFrame>& frames) {
+    std::vector<double> timestamps;
+    for (const auto& frame : frames) {
+        timestamps.push_back(frame.timestamp_ms);
+    }
+    return timestamps;
+}
+
+void test_sample_timestamps() {
+    // 10 秒、2 fps：20 个区间，每个取中点
+    std::vector<double> ts = VideoIngest::sample_timestamps(10000.0, 2.0f, 0);
+    CHECK(ts.size() == 20);
+    CHECK_NEAR(ts.front(), 250.0, 1e-9);
+    CHECK_NEAR(ts[1], 750.0, 1e-9);
+    CHECK_NEAR(ts.back(), 9750.0, 1e-9);
+
+    // 超过上限时在全片均匀取点，仍取区间中点
+    ts = VideoIngest::sample_timestamps(10000.0, 2.0f, 4);
+    CHECK(ts.size() == 4);
+    CHECK_NEAR(ts[0], 1250.0, 1e-9);
+    CHECK_NEAR(ts[1], 3750.0, 1e-9);
+    CHECK_NEAR(ts[3], 8750.0, 1e-9);
+
+    // 未超过上限时不改变采样间隔
+    ts = VideoIngest::sample_timestamps(3000.0, 1.0f, 10);
+    CHECK(ts == (std::vector<double>{500.0, 1500.0, 2500.0}));
+
+    // 短于一个采样区间的视频仍取一帧，取全片中点而不是越过片尾
+    ts = VideoIngest::sample_timestamps(400.0, 1.0f, 0);
+    CHECK(ts.size() == 1);
+    CHECK_NEAR(ts.front(), 200.0, 1e-9);
+
+    CHECK(VideoIngest::sample_timestamps(0.0, 1.0f, 0).empty());
+    CHECK(VideoIngest::sample_timestamps(10000.0, 0.0f, 0).empty());
+}
+
+void test_dhash() {
+    // 每个比较位为“左边像素更亮”，9x8 缩放后单调变化的图像各位相同
+    cv::Mat rising = ramp(64, 72, 10, 3);
+    cv::Mat falling = ramp(64, 72, 230, -3);
+    CHECK(VideoIngest::dhash(rising) == 0);
+    CHECK(VideoIngest::dhash(falling) == ~0ull);
+    CHECK(VideoIngest::dhash(cv::Mat(64, 72, CV_8UC1, cv::Scalar(128))) == 0);
+
+    // 三通道输入先转灰度，与灰度输入一致
+    cv::Mat bgr;
+    cv::cvtColor(falling, bgr, cv::COLOR_GRAY2BGR);
+    CHECK(VideoIngest::dhash(bgr) == ~0ull);
+}
+
+void test_prune_by_hamming_distance() {
+    // 缩略图相同，但 hash 汉明距离超过阈值时保留
+    std::vector<VideoFrame> frames;
+    frames.push_back(make_frame(0.0, 0x0ull, 100));
+    frames.push_back(make_frame(1.0, 0xFull, 100));         // 距离 4，疑似重复，SAD 为 0 丢弃
+    frames.push_back(make_frame(2.0, 0x1Full, 100));        // 距离 5，保留
+    std::vector<VideoFrame> kept = VideoIngest::prune_duplicates(std::move(frames), 4, 3.0);
+    CHECK(timestamps_of(kept) == (std::vector<double>{0.0, 2.0}));
+}
+
+void test_prune_by_sad() {
+    // hash 相同时只有 SAD 不超过阈值才丢弃
+    std::vector<VideoFrame> frames;
+    frames.push_back(make_frame(0.0, 0x0ull, 100));
+    frames.push_back(make_frame(1.0, 0x0ull, 103));         // SAD 3，等于阈值，丢弃
+    frames.push_back(make_frame(2.0, 0x0ull, 96));          // SAD 4，保留
+    std::vector<VideoFrame> kept = VideoIngest::prune_duplicates(std::move(frames), 4, 3.0);
+    CHECK(timestamps_of(kept) == (std::vector<double>{0.0, 2.0}));
+}
+
+void test_prune_compares_with_last_kept() {
+    // 缓慢变化的画面：与前一帧的差都在阈值内，但与上一保留帧的差累积超过阈值后保留
+    std::vector<VideoFrame> frames;
+    frames.push_back(make_frame(0.0, 0x0ull, 100));
+    frames.push_back(make_frame(1.0, 0x0ull, 102));
+    frames.push_back(make_frame(2.0, 0x0ull, 104));
+    frames.push_back(make_frame(3.0, 0x0ull, 106));
+    frames.push_back(make_frame(4.0, 0x0ull, 108));
+    std::vector<VideoFrame> kept = VideoIngest::prune_duplicates(std::move(frames), 4, 3.0);
+    CHECK(timestamps_of(kept) == (std::vector<double>{0.0, 2.0, 4.0}));
+}
+
+void test_prune_skips_undecoded() {
+    // 解码失败的帧既不保留也不作为比较基准
+    std::vector<VideoFrame> frames;
+    frames.push_back(make_frame(0.0, 0x0ull, 100));
+    VideoFrame missing;
+    missing.timestamp_ms = 1.0;
+    frames.push_back(missing);
+    frames.push_back(make_frame(2.0, 0x0ull, 101));
+    frames.push_back(make_frame(3.0, ~0ull, 200));
+    std::vector<VideoFrame> kept = VideoIngest::prune_duplicates(std::move(frames), 4, 3.0);
+    CHECK(timestamps_of(kept) == (std::vector<double>{0.0, 3.0}));
+    CHECK(VideoIngest::prune_duplicates({}, 4, 3.0).empty());
+}
+
+}  // namespace
+
+int main() {
+    test_sample_timestamps();
+    test_dhash();
+    test_prune_by_hamming_distance();
+    test_prune_by_sad();
+    test_prune_compares_with_last_kept();
+    test_prune_skips_undecoded();
+    return test_result("video_ingest_test");
+}
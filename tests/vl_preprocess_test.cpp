@@ -0,0 +1,112 @@
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "pb_sdk/fp16.h"
+#include "pb_sdk/vl_preprocess.h"
+#include "test_util.h"
+
+namespace {
+
+/**
+ * @brief 像素值编码位置与帧序号，便于核对打包顺序
+ */
+cv::Mat coded_frame(int size, int t) {
+    cv::Mat rgb(size, size, CV_8UC3);
+    for (int y = 0; y < size; ++y) {
+        uint8_t* row = rgb.ptr<uint8_t>(y);
+        for (int x = 0; x < size; ++x) {
+            row[3 * x] = static_cast<uint8_t>(x);
+            row[3 * x + 1] = static_cast<uint8_t>(y);
+            row[3 * x + 2] = static_cast<uint8_t>(100 + t);
+        }
+    }
+    return rgb;
+}
+
+void test_smart_resize_matches_reference() {
+    // 参考值来自 Qwen2-VL 的 Python smart_resize
+    CHECK(VlPreprocessor::smart_resize(1080, 1920, 28, 56 * 56, 28 * 28 * 1280) == cv::Size(1316, 728));
+    CHECK(VlPreprocessor::smart_resize(480, 640, 28, 56 * 56, 28 * 28 * 1280) == cv::Size(644, 476));
+    CHECK(VlPreprocessor::smart_resize(10, 20, 28, 56 * 56, 28 * 28 * 1280) == cv::Size(84, 56));
+    CHECK(VlPreprocessor::smart_resize(1080, 1920, 28, 56 * 56, 448 * 448) == cv::Size(588, 336));
+}
+
+void test_video_patch_layout() {
+    VlPreprocessParams params;
+    VlPreprocessor preprocessor(params, 1);
+    const int size = 56;
+    // 3 帧：不足 temporal_patch_size 整数倍，重复最后一帧
+    std::vector<cv::Mat> frames{coded_frame(size, 0), coded_frame(size, 1), coded_frame(size, 2)};
+    VlPixelData out = preprocessor.preprocess_video(frames, true);
+
+    const int ps = params.patch_size;
+    const int tps = params.temporal_patch_size;
+    CHECK(out.grid_t == 2);
+    CHECK(out.grid_h == 4);
+    CHECK(out.grid_w == 4);
+    CHECK((out.shape == std::vector<int64_t>{2 * 4 * 4, 3LL * tps * ps * ps}));
+    CHECK(out.pixel_data.size() == static_cast<size_t>(out.shape[0] * out.shape[1]));
+
+    auto expect = [&](int c, int value) {
+        return float_to_fp16((value / 255.0f - params.mean[c]) / params.stddev[c]);
+    };
+    // 第 1 个时间块、2x2 合并块 (bh=1, bw=0) 中的 (mh=0, mw=1) patch，
+    // 行序为 [grid_t, grid_h/m, grid_w/m, m, m]，行内为 [C, T, P, P]
+    const int t = 1, bh = 1, bw = 0, mh = 0, mw = 1;
+    const int64_t row = ((static_cast<int64_t>(t) * 2 + bh) * 2 + bw) * 4 + mh * 2 + mw;
+    const int py0 = (bh * 2 + mh) * ps;
+    const int px0 = (bw * 2 + mw) * ps;
+    for (int c = 0; c < 3; ++c) {
+        for (int tt = 0; tt < tps; ++tt) {
+            const int frame = std::min(t * tps + tt, 2);
+            for (int y : {0, 5, ps - 1}) {
+                for (int x : {0, 7, ps - 1}) {
+                    const size_t idx = static_cast<size_t>(row * out.shape[1]) + ((c * tps + tt) * ps + y) * ps + x;
+                    const int value = c == 0 ? px0 + x : (c == 1 ? py0 + y : 100 + frame);
+                    CHECK(out.pixel_data[idx] == expect(c, value));
+                }
+            }
+        }
+    }
+}
+
+void test_downscale_is_antialiased() {
+    // 1 像素棋盘格缩小 4 倍：抗锯齿后接近均值 127.5，不应出现混叠条纹
+    cv::Mat board(256, 256, CV_8UC3);
+    for (int y = 0; y < board.rows; ++y) {
+        for (int x = 0; x < board.cols; ++x) {
+            board.at<cv::Vec3b>(y, x) = cv::Vec3b::all((x + y) % 2 == 0 ? 255 : 0);
+        }
+    }
+    cv::Mat small = VlPreprocessor::resize(board, cv::Size(64, 64));
+    CHECK(small.size() == cv::Size(64, 64));
+    double min_value = 0.0;
+    double max_value = 0.0;
+    cv::minMaxLoc(small.reshape(1), &min_value, &max_value);
+    CHECK(min_value >= 120.0);
+    CHECK(max_value <= 135.0);
+
+    // 尺寸相同时不缩放
+    cv::Mat same = VlPreprocessor::resize(board, board.size());
+    CHECK(same.data == board.data);
+}
+
+void test_client_timing_is_separate() {
+    std::vector<VlPixelData> results(2);
+    results[0].preprocess_ms = 1.5;
+    results[1].preprocess_ms = 2.0;
+    CHECK_NEAR(VlPreprocessor::total_preprocess_ms(results), 3.5, 1e-9);
+}
+
+}  // namespace
+
+int main() {
+    test_smart_resize_matches_reference();
+    test_video_patch_layout();
+    test_downscale_is_antialiased();
+    test_client_timing_is_separate();
+    return test_result("vl_preprocess_test");
+}